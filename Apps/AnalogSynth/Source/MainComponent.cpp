@@ -20,6 +20,7 @@ MainComponent::MainComponent()
     waveformBox.addItem ("Sine",   1);
     waveformBox.addItem ("Saw",    2);
     waveformBox.addItem ("Square", 3);
+    waveformBox.addItem ("Pluck",  4);
     waveformBox.setSelectedId (1, juce::dontSendNotification);
     waveformBox.addListener (this);
     addAndMakeVisible (waveformBox);
@@ -73,6 +74,8 @@ MainComponent::MainComponent()
     addAndMakeVisible (keyboardComponent);
     keyboardState.addListener (this);
 
+    addAndMakeVisible (recorderControls);
+
     // DSP setup defaults
     setWaveform (0);
     outputGain.setGainLinear (0.2f); // prevent loudness
@@ -116,6 +119,11 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
 
     // Initialize oscillator frequency to default target (440 Hz) until a MIDI note is played
     osc.setFrequency (targetFrequencyHz.load());
+
+    strings.prepare (sampleRate);
+    keyboardMidi.ensureSize (2048);
+
+    recorder.prepareToPlay (sampleRate, (int) spec.numChannels);
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
@@ -146,12 +154,24 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     juce::dsp::AudioBlock<float> monoBlock (monoChans, (size_t) 1, (size_t) numSamples);
     juce::dsp::ProcessContextReplacing<float> monoContext (monoBlock);
 
+    // Keyboard notes for this block, at their sample positions (always drained, so
+    // switching to Pluck doesn't replay old notes)
+    keyboardMidi.clear();
+    keyboardState.processNextMidiBuffer (keyboardMidi, 0, (int) numSamples, true);
 
-    // Generate oscillator
-    osc.process (monoContext);
+    const bool pluck = currentWaveform.load() == 3;
 
-    // Apply ADSR to the mono buffer by wrapping monoData in a temporary AudioBuffer<float>
+    if (pluck)
+    {
+        // Plucked strings: each note on its own string, sample accurate
+        strings.renderNextBlock (monoData.get(), keyboardMidi, 0, (int) numSamples);
+    }
+    else
     {
+        // Generate oscillator
+        osc.process (monoContext);
+
+        // Apply ADSR to the mono buffer by wrapping monoData in a temporary AudioBuffer<float>
         juce::AudioBuffer<float> monoAudioBuffer (monoChans, 1, (int) numSamples);
         adsr.applyEnvelopeToBuffer (monoAudioBuffer, 0, (int) numSamples);
     }
@@ -167,10 +187,13 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     float* mono = monoBlock.getChannelPointer (0);
     float smoothVal = 0.0f;
 
-    for (int i = 0; i < numSamples; ++i)
+    if (! pluck) // the strings take the velocity per note
     {
-        smoothVal = velocityGain.getNextValue();
-        mono[i] *= smoothVal;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            smoothVal = velocityGain.getNextValue();
+            mono[i] *= smoothVal;
+        }
     }
 
     // Copy mono to stereo and apply output gain
@@ -179,11 +202,14 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
 
     juce::dsp::ProcessContextReplacing<float> stereoContext (sub);
     outputGain.process (stereoContext);
+
+    // Capture the final output (lock-free hand-off to the writer thread)
+    recorder.pushBlock (*buffer, startSample, numSamples);
 }
 
 void MainComponent::releaseResources()
 {
-    // Nothing heavy to release beyond DSP components
+    strings.release();
 }
 
 //==============================================================================
@@ -208,6 +234,7 @@ void MainComponent::resized()
         waveformBox.setBounds (wBox);
 
         topRow.removeFromLeft (gap);
+        recorderControls.setBounds (topRow);
     }
 
     area.removeFromTop (8); // small spacer
@@ -279,8 +306,8 @@ void MainComponent::comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged)
     if (comboBoxThatHasChanged == &waveformBox)
     {
         const int idx = waveformBox.getSelectedId() - 1; // 0-based
-        currentWaveform.store (juce::jlimit (0, 2, idx));
-        setWaveform (currentWaveform.load());
+        currentWaveform.store (juce::jlimit (0, 3, idx));
+        setWaveform (currentWaveform.load()); // Pluck leaves the oscillator on a sine (unused)
     }
 }
 
@@ -329,6 +356,11 @@ void MainComponent::updateAdsrParamsFromUI()
     adsrParams.sustain = (float) sustainSlider.getValue();
     adsrParams.release = (float) releaseSlider.getValue();
     adsr.setParameters (adsrParams);
+
+    // The strings use the release time after a note-off
+    auto stringParams = strings.getParameters();
+    stringParams.releaseSeconds = adsrParams.release;
+    strings.setParameters (stringParams);
 }
 
 void MainComponent::updateFilterFromUI()
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../Utils/Audio/ThreadedRecorder.h"
+#include "../../../Utils/DSP/PluckedStrings.h"
 
 //==============================================================================
-// A simple analog-style synth: oscillator + ADSR + state-variable low-pass filter
+// A simple analog-style synth: oscillator + ADSR + state-variable low-pass filter.
+// The "Pluck" waveform swaps the oscillator for a bank of plucked strings (polyphonic).
 class MainComponent  : public juce::AudioAppComponent,
                        public juce::MidiKeyboardStateListener,
                        private juce::ComboBox::Listener,
@@ -44,6 +47,10 @@ private:
     juce::MidiKeyboardState keyboardState;
     juce::MidiKeyboardComponent keyboardComponent { keyboardState, juce::MidiKeyboardComponent::horizontalKeyboard };
 
+    // Output capture
+    ThreadedRecorder recorder;
+    RecorderControls recorderControls { recorder };
+
     // DSP
     juce::dsp::Oscillator<float> osc;
     juce::dsp::StateVariableTPTFilter<float> filter;
@@ -55,9 +62,13 @@ private:
     
     juce::SmoothedValue<float> velocityGain;
 
+    // Plucked strings: one string per note, played from the keyboard's MIDI
+    PluckedStrings<64> strings;
+    juce::MidiBuffer keyboardMidi;
+
     // State
     std::atomic<float> targetFrequencyHz { 440.0f };
-    std::atomic<int> currentWaveform { 0 }; // 0: Sine, 1: Saw, 2: Square
+    std::atomic<int> currentWaveform { 0 }; // 0: Sine, 1: Saw, 2: Square, 3: Pluck
 
     std::atomic<float> cutoffHz { 20000.0f };
     std::atomic<float> resonance { 0.7f };
@@ -11,6 +11,8 @@ MainComponent::MainComponent()
 
 MainComponent::~MainComponent()
 {
+    stopTimer();
+
     {
         juce::MessageManagerLock mmLock; // remove listener safely
         transport.removeChangeListener (this);
@@ -35,6 +37,28 @@ void MainComponent::setupGuiComponents()
     playButton.onClick = [this] { transport.start(); setButtonsEnabledState(); };
     stopButton.onClick = [this] { transport.stop();  setButtonsEnabledState(); };
 
+    // Multitrack controls
+    addAndMakeVisible (addTracksButton);
+    addAndMakeVisible (clearTracksButton);
+    addTracksButton.onClick   = [this] { chooseAndAddTracks(); };
+    clearTracksButton.onClick = [this] { clearTracks(); };
+
+    masterGainSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    masterGainSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 60, 20);
+    masterGainSlider.setRange (0.0, 2.0, 0.01);
+    masterGainSlider.setValue (1.0, juce::dontSendNotification);
+    masterGainSlider.onValueChange = [this] { mixer.setMasterGain ((float) masterGainSlider.getValue()); };
+    addAndMakeVisible (masterGainSlider);
+
+    masterGainLabel.attachToComponent (&masterGainSlider, true);
+    addAndMakeVisible (masterGainLabel);
+
+    addAndMakeVisible (statsLabel);
+
+    trackViewport.setViewedComponent (&trackList, false);
+    trackViewport.setScrollBarsShown (true, false);
+    addAndMakeVisible (trackViewport);
+
     setButtonsEnabledState();
 }
 
@@ -60,7 +84,7 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
     // Fill from transport, or clear if no source
-    if (readerSource == nullptr)
+    if (! multitrackMode && readerSource == nullptr)
     {
         bufferToFill.clearActiveBufferRegion();
         return;
@@ -92,6 +116,22 @@ void MainComponent::resized()
     playButton.setBounds (row.removeFromLeft (120));
     row.removeFromLeft (10);
     stopButton.setBounds (row.removeFromLeft (120));
+
+    // Multitrack rows: buttons + master, stats, then the scrollable track list
+    area.removeFromTop (20);
+    auto multiRow = area.removeFromTop (buttonHeight);
+    addTracksButton.setBounds (multiRow.removeFromLeft (120));
+    multiRow.removeFromLeft (10);
+    clearTracksButton.setBounds (multiRow.removeFromLeft (120));
+    multiRow.removeFromLeft (70); // attached label
+    masterGainSlider.setBounds (multiRow);
+
+    area.removeFromTop (10);
+    statsLabel.setBounds (area.removeFromTop (24));
+
+    area.removeFromTop (10);
+    trackViewport.setBounds (area);
+    layoutTrackList();
 }
 
 //==============================================================================
@@ -132,6 +172,9 @@ void MainComponent::chooseAndLoadFile()
 
 void MainComponent::loadURL (const juce::URL& url)
 {
+    // Loading a single file leaves multitrack mode
+    setMultitrackMode (false);
+
     // Stop current playback and detach current source
     transport.stop();
     transport.setSource (nullptr);
@@ -150,8 +193,10 @@ void MainComponent::loadURL (const juce::URL& url)
     // Capture the file's sample rate from the reader before transferring ownership
     const double fileSampleRate = reader->sampleRate;
 
-    // Create the reader source (takes ownership of reader)
-    readerSource.reset (new juce::AudioFormatReaderSource (reader.release(), true));
+    // Create the reader source (takes ownership of reader). Compressed local files get a
+    // seek index built in the background so scrubbing doesn't rescan from the start.
+    const auto localFile = url.isLocalFile() ? url.getLocalFile() : juce::File();
+    readerSource.reset (new SeekIndexedAudioSource (reader.release(), localFile));
 
     // Set the source; pass the file's sample rate
     transport.setSource (readerSource.get(), 0, nullptr, fileSampleRate);
@@ -164,7 +209,7 @@ void MainComponent::loadURL (const juce::URL& url)
 
 void MainComponent::setButtonsEnabledState()
 {
-    const bool hasFile = (readerSource != nullptr);
+    const bool hasFile = multitrackMode ? (mixer.getNumTracks() > 0) : (readerSource != nullptr);
     const bool isPlaying = transport.isPlaying();
 
     playButton.setEnabled (hasFile && !isPlaying);
@@ -184,3 +229,130 @@ void MainComponent::changeListenerCallback (juce::ChangeBroadcaster* source)
         setButtonsEnabledState();
     }
 }
+
+//==============================================================================
+// Multitrack mode
+
+MainComponent::TrackStrip::TrackStrip (MultitrackMixer& mixer, int trackIndex)
+{
+    nameLabel.setText (mixer.getTrackName (trackIndex), juce::dontSendNotification);
+    addAndMakeVisible (nameLabel);
+
+    gainSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    gainSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 50, 20);
+    gainSlider.setRange (0.0, 2.0, 0.01);
+    gainSlider.setValue (1.0, juce::dontSendNotification);
+    gainSlider.onValueChange = [&mixer, trackIndex, this] { mixer.setTrackGain (trackIndex, (float) gainSlider.getValue()); };
+    addAndMakeVisible (gainSlider);
+
+    panSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    panSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 50, 20);
+    panSlider.setRange (-1.0, 1.0, 0.01);
+    panSlider.setValue (0.0, juce::dontSendNotification);
+    panSlider.onValueChange = [&mixer, trackIndex, this] { mixer.setTrackPan (trackIndex, (float) panSlider.getValue()); };
+    addAndMakeVisible (panSlider);
+
+    muteButton.onClick = [&mixer, trackIndex, this] { mixer.setTrackMute (trackIndex, muteButton.getToggleState()); };
+    addAndMakeVisible (muteButton);
+}
+
+void MainComponent::TrackStrip::resized()
+{
+    auto row = getLocalBounds().reduced (2);
+    nameLabel.setBounds (row.removeFromLeft (180));
+    muteButton.setBounds (row.removeFromRight (70));
+
+    const int sliderWidth = row.getWidth() / 2;
+    gainSlider.setBounds (row.removeFromLeft (sliderWidth));
+    panSlider.setBounds (row);
+}
+
+void MainComponent::chooseAndAddTracks()
+{
+    auto chooser = std::make_shared<juce::FileChooser> ("Select audio files to add as tracks...",
+                                                         juce::File(),
+                                                         "*.wav;*.aiff;*.mp3;*.flac;*.ogg;*.m4a");
+    auto flags = juce::FileBrowserComponent::openMode
+               | juce::FileBrowserComponent::canSelectFiles
+               | juce::FileBrowserComponent::canSelectMultipleItems;
+
+    chooser->launchAsync (flags, [this, chooser] (const juce::FileChooser& fc)
+    {
+        for (const auto& url : fc.getURLResults())
+            addTrack (url);
+    });
+}
+
+void MainComponent::addTrack (const juce::URL& url)
+{
+    setMultitrackMode (true);
+
+    // Tracks can be added while playing: the mixer prefills the new track before it goes live
+    const int index = mixer.addTrack (url);
+    if (index < 0)
+        return;
+
+    trackList.addAndMakeVisible (trackStrips.add (new TrackStrip (mixer, index)));
+    layoutTrackList();
+    setButtonsEnabledState();
+}
+
+void MainComponent::clearTracks()
+{
+    transport.stop();
+    trackStrips.clear();
+    mixer.removeAllTracks();
+    layoutTrackList();
+    setButtonsEnabledState();
+}
+
+void MainComponent::setMultitrackMode (bool shouldBeMultitrack)
+{
+    if (multitrackMode == shouldBeMultitrack)
+        return;
+
+    transport.stop();
+    transport.setSource (nullptr);
+
+    multitrackMode = shouldBeMultitrack;
+
+    if (multitrackMode)
+    {
+        readerSource.reset();
+
+        // The mixer resamples each track itself, so no rate correction here
+        transport.setSource (&mixer, 0, nullptr, 0.0);
+        startTimerHz (4);
+    }
+    else
+    {
+        stopTimer();
+        statsLabel.setText ({}, juce::dontSendNotification);
+    }
+
+    setButtonsEnabledState();
+}
+
+void MainComponent::layoutTrackList()
+{
+    const int stripHeight = 30;
+    const int width = trackViewport.getMaximumVisibleWidth();
+
+    trackList.setSize (width, stripHeight * trackStrips.size());
+
+    for (int i = 0; i < trackStrips.size(); ++i)
+        trackStrips.getUnchecked (i)->setBounds (0, i * stripHeight, width, stripHeight);
+}
+
+void MainComponent::timerCallback()
+{
+    // CPU figure comes from the device callback timing; disk figure is what the reader
+    // threads actually read from the track files since the previous tick
+    const double cpuPercent = deviceManager.getCpuUsage() * 100.0;
+    const double diskMBs = mixer.getDiskBytesPerSecond() / (1024.0 * 1024.0);
+
+    statsLabel.setText ("Tracks: " + juce::String (mixer.getNumTracks())
+                          + "   CPU: " + juce::String (cpuPercent, 1) + " %"
+                          + "   Disk: " + juce::String (diskMBs, 2) + " MB/s",
+                        juce::dontSendNotification);
+}
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../Utils/Audio/SeekIndexedAudioSource.h"
+#include "MultitrackMixer.h"
 
 class MainComponent  : public juce::AudioAppComponent,
                        private juce::Button::Listener,
-                       private juce::ChangeListener
+                       private juce::ChangeListener,
+                       private juce::Timer
 {
 public:
     //==============================================================================
@@ -28,13 +31,40 @@ private:
     // Audio playback members
     juce::AudioFormatManager formatManager;
     juce::AudioTransportSource transport;
-    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
+    std::unique_ptr<SeekIndexedAudioSource> readerSource; // constant-time seeks once indexed
+
+    // Multitrack mode: the transport plays the mixer instead of a single file
+    MultitrackMixer mixer { formatManager };
+    bool multitrackMode = false;
 
     // Simple UI
     juce::TextButton loadButton { "Load..." };
     juce::TextButton playButton { "Play" };
     juce::TextButton stopButton { "Stop" };
 
+    // Multitrack UI
+    juce::TextButton addTracksButton   { "Add tracks..." };
+    juce::TextButton clearTracksButton { "Clear tracks" };
+    juce::Slider masterGainSlider;
+    juce::Label  masterGainLabel { {}, "Master" };
+    juce::Label  statsLabel;
+
+    // One row per track: name, gain, pan, mute
+    struct TrackStrip : public juce::Component
+    {
+        TrackStrip (MultitrackMixer& mixer, int trackIndex);
+        void resized() override;
+
+        juce::Label nameLabel;
+        juce::Slider gainSlider;
+        juce::Slider panSlider;
+        juce::ToggleButton muteButton { "Mute" };
+    };
+
+    juce::OwnedArray<TrackStrip> trackStrips;
+    juce::Component trackList;
+    juce::Viewport trackViewport;
+
     // Button::Listener
     void buttonClicked (juce::Button* button) override;
 
@@ -46,5 +76,14 @@ private:
     void loadURL (const juce::URL& url);
     void setButtonsEnabledState();
 
+    void chooseAndAddTracks();
+    void addTrack (const juce::URL& url);
+    void clearTracks();
+    void setMultitrackMode (bool shouldBeMultitrack);
+    void layoutTrackList();
+
+    // Timer: CPU / disk figures for the multitrack mode
+    void timerCallback() override;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
@@ -0,0 +1,515 @@
+#include "MultitrackMixer.h"
+
+//==============================================================================
+// Passes a track's file reads through and adds them to the mixer's byte count, so the
+// disk figure is what the readers really pulled rather than a nominal bit rate
+class CountingInputStream : public juce::InputStream
+{
+public:
+    CountingInputStream (std::unique_ptr<juce::InputStream> sourceStream, std::atomic<juce::int64>& counter)
+        : source (std::move (sourceStream)), bytesRead (counter)
+    {
+    }
+
+    juce::int64 getTotalLength() override                   { return source->getTotalLength(); }
+    bool isExhausted() override                             { return source->isExhausted(); }
+    juce::int64 getPosition() override                      { return source->getPosition(); }
+    bool setPosition (juce::int64 newPosition) override     { return source->setPosition (newPosition); }
+
+    int read (void* destBuffer, int maxBytesToRead) override
+    {
+        const int num = source->read (destBuffer, maxBytesToRead);
+
+        if (num > 0)
+            bytesRead.fetch_add (num);
+
+        return num;
+    }
+
+private:
+    std::unique_ptr<juce::InputStream> source;
+    std::atomic<juce::int64>& bytesRead;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CountingInputStream)
+};
+
+//==============================================================================
+MultitrackMixer::MultitrackMixer (juce::AudioFormatManager& formatManagerToUse)
+    : formatManager (formatManagerToUse)
+{
+    // Decoding is spread over a few reader threads; tracks are assigned round-robin
+    const int numReaderThreads = juce::jlimit (1, 8, juce::SystemStats::getNumCpus() / 2);
+
+    for (int i = 0; i < numReaderThreads; ++i)
+    {
+        auto* thread = readerThreads.add (new juce::TimeSliceThread ("Multitrack reader " + juce::String (i + 1)));
+        thread->startThread();
+    }
+}
+
+MultitrackMixer::~MultitrackMixer()
+{
+    // tracks use the reader threads, so they must go before the threads stop
+    for (auto& track : tracks)
+        track.reset();
+
+    for (auto* thread : readerThreads)
+        thread->stopThread (2000);
+}
+
+//==============================================================================
+// Track management
+
+int MultitrackMixer::addTrack (const juce::URL& url)
+{
+    const juce::ScopedLock tl (trackLock);
+
+    const int index = numTracks.load();
+    if (index >= maxTracks)
+        return -1;
+
+    auto inputStream = url.createInputStream (juce::URL::InputStreamOptions (juce::URL::ParameterHandling::inAddress));
+    if (inputStream == nullptr)
+        return -1;
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (
+        std::make_unique<CountingInputStream> (std::move (inputStream), bytesRead)));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return -1;
+
+    auto track = std::make_unique<Track>();
+    track->name = url.getFileName();
+    track->fileSampleRate = reader->sampleRate;
+    track->fileLength = reader->lengthInSamples;
+    track->source = std::make_unique<juce::AudioFormatReaderSource> (reader.release(), true);
+    track->decoder = track->source.get();
+    track->readerThread = readerThreads.getUnchecked (index % readerThreads.size());
+
+    double rate;
+    juce::int64 startPosition;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        rate = deviceSampleRate;
+        startPosition = position;
+    }
+
+    // Prefills the track before it goes live, with no lock held (trackLock keeps the device
+    // from being re-prepared meanwhile). The timeline moves on while the file is read; the
+    // track catches up by skipping the samples decoded for the time in between.
+    if (rate > 0.0)
+    {
+        prepareTrack (*track, rate);
+        track->length = getOutputLength (*track, rate);
+        seekTrack (*track, startPosition);
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        tracks[index] = std::move (track);
+        numTracks.store (index + 1);
+    }
+
+    return index;
+}
+
+void MultitrackMixer::removeAllTracks()
+{
+    const juce::ScopedLock tl (trackLock);
+
+    std::unique_ptr<Track> removed[maxTracks];
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        for (int i = 0; i < maxTracks; ++i)
+            removed[i] = std::move (tracks[i]);
+
+        numTracks.store (0);
+        position = 0;
+    }
+    // removed tracks are destroyed here, outside the lock
+}
+
+juce::String MultitrackMixer::getTrackName (int trackIndex) const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    return juce::isPositiveAndBelow (trackIndex, numTracks.load()) ? tracks[trackIndex]->name : juce::String();
+}
+
+void MultitrackMixer::setTrackGain (int trackIndex, float gain)
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    if (juce::isPositiveAndBelow (trackIndex, numTracks.load()))
+        tracks[trackIndex]->gain.store (juce::jmax (0.0f, gain));
+}
+
+void MultitrackMixer::setTrackPan (int trackIndex, float pan)
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    if (juce::isPositiveAndBelow (trackIndex, numTracks.load()))
+        tracks[trackIndex]->pan.store (juce::jlimit (-1.0f, 1.0f, pan));
+}
+
+void MultitrackMixer::setTrackMute (int trackIndex, bool shouldMute)
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    if (juce::isPositiveAndBelow (trackIndex, numTracks.load()))
+        tracks[trackIndex]->muted.store (shouldMute);
+}
+
+void MultitrackMixer::setMasterGain (float gain)
+{
+    masterGain.store (juce::jmax (0.0f, gain));
+}
+
+double MultitrackMixer::getDiskBytesPerSecond()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto total = bytesRead.load();
+    const auto elapsedMs = now - lastDiskCheckMs;
+
+    const double rate = (lastDiskCheckMs > 0.0 && elapsedMs > 0.0)
+                            ? (double) (total - lastBytesRead) * 1000.0 / elapsedMs
+                            : 0.0;
+
+    lastDiskCheckMs = now;
+    lastBytesRead = total;
+    return rate;
+}
+
+//==============================================================================
+// AudioSource
+
+void MultitrackMixer::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    trackBuffer.setSize (2, juce::jmax (1, samplesPerBlockExpected));
+
+    const juce::ScopedLock tl (trackLock);
+
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        deviceSampleRate = sampleRate;
+        lastMasterGain = masterGain.load();
+    }
+
+    // Re-preparing decodes every track again from disk, so it runs with the SpinLock free
+    // while the audio thread outputs silence
+    const int count = suspendTracks();
+
+    for (int i = 0; i < count; ++i)
+        prepareTrack (*tracks[i], sampleRate);
+
+    juce::int64 startPosition;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+
+        for (int i = 0; i < count; ++i)
+            tracks[i]->length = getOutputLength (*tracks[i], sampleRate);
+
+        startPosition = position;
+    }
+
+    for (int i = 0; i < count; ++i)
+        seekTrack (*tracks[i], startPosition);
+
+    resumeTracks();
+}
+
+void MultitrackMixer::releaseResources()
+{
+    const juce::ScopedLock tl (trackLock);
+
+    {
+        // tracks added from now on are prepared by the next prepareToPlay
+        const juce::SpinLock::ScopedLockType sl (lock);
+        deviceSampleRate = 0.0;
+    }
+
+    const int count = suspendTracks();
+
+    for (int i = 0; i < count; ++i)
+        tracks[i]->decoder->releaseResources();
+}
+
+void MultitrackMixer::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto& buffer = *bufferToFill.buffer;
+    const int startSample = bufferToFill.startSample;
+    const int numSamples = bufferToFill.numSamples;
+
+    bufferToFill.clearActiveBufferRegion();
+
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    if (suspended)
+        return;
+
+    // Hosts may deliver more than the expected block size: mix in trackBuffer-sized chunks
+    for (int done = 0; done < numSamples;)
+    {
+        const int n = juce::jmin (numSamples - done, trackBuffer.getNumSamples());
+
+        for (int i = 0; i < numTracks.load(); ++i)
+            mixTrack (*tracks[i], buffer, startSample + done, n);
+
+        position += n;
+        done += n;
+    }
+
+    // Master bus
+    const float newMasterGain = masterGain.load();
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        buffer.applyGainRamp (ch, startSample, numSamples, lastMasterGain, newMasterGain);
+
+    lastMasterGain = newMasterGain;
+}
+
+void MultitrackMixer::mixTrack (Track& track, juce::AudioBuffer<float>& dest, int startSample, int numSamples)
+{
+    // tracks shorter than the timeline simply fall silent
+    const auto available = track.length - position;
+    if (available <= 0)
+        return;
+
+    const int n = (int) juce::jmin ((juce::int64) numSamples, available);
+
+    // After an underrun the FIFO starts behind the timeline: skip what is already due
+    if (track.readPosition < position)
+    {
+        const int skip = (int) juce::jmin ((juce::int64) track.fifo.getNumReady(), position - track.readPosition);
+        track.fifo.finishedRead (skip);
+        track.readPosition += skip;
+    }
+
+    int numRead = 0;
+
+    if (track.readPosition == position)
+    {
+        int start1, size1, start2, size2;
+        track.fifo.prepareToRead (n, start1, size1, start2, size2);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            if (size1 > 0)
+                trackBuffer.copyFrom (ch, 0, track.fifoBuffer, ch, start1, size1);
+            if (size2 > 0)
+                trackBuffer.copyFrom (ch, size1, track.fifoBuffer, ch, start2, size2);
+        }
+
+        numRead = size1 + size2;
+        track.fifo.finishedRead (numRead);
+        track.readPosition += numRead;
+    }
+
+    // not decoded in time: silence rather than waiting for the reader
+    if (numRead < n)
+    {
+        trackBuffer.clear (numRead, n - numRead);
+        underruns.fetch_add (1);
+    }
+
+    // Balance law, not constant power: both sides at unity in the centre, and panning turns
+    // the far side down along a sine while the near side stays at unity, so the total power
+    // dips by 3 dB at the extremes
+    const float pan = track.pan.load();
+    const float angle = (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+    const float gain = track.muted.load() ? 0.0f : track.gain.load();
+    const float gainL = gain * juce::jmin (1.0f, juce::MathConstants<float>::sqrt2 * std::cos (angle));
+    const float gainR = gain * juce::jmin (1.0f, juce::MathConstants<float>::sqrt2 * std::sin (angle));
+
+    const float gains[]     = { gainL, gainR };
+    const float lastGains[] = { track.lastGainL, track.lastGainR };
+
+    for (int ch = 0; ch < juce::jmin (2, dest.getNumChannels()); ++ch)
+    {
+        if (gains[ch] == lastGains[ch])
+        {
+            if (gains[ch] != 0.0f)
+                juce::FloatVectorOperations::addWithMultiply (dest.getWritePointer (ch, startSample),
+                                                              trackBuffer.getReadPointer (ch), gains[ch], n);
+        }
+        else
+        {
+            // control moved: ramp over this block to avoid zipper noise
+            dest.addFromWithRamp (ch, startSample, trackBuffer.getReadPointer (ch), n, lastGains[ch], gains[ch]);
+        }
+    }
+
+    track.lastGainL = gainL;
+    track.lastGainR = gainR;
+}
+
+//==============================================================================
+// PositionableAudioSource
+
+void MultitrackMixer::setNextReadPosition (juce::int64 newPosition)
+{
+    const juce::ScopedLock tl (trackLock);
+
+    // Every reader restarts at the new position: the tracks are taken off the audio thread
+    // and their readers stopped first, so nothing reads a FIFO while it is emptied
+    const int count = suspendTracks();
+
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        position = juce::jmax ((juce::int64) 0, newPosition);
+    }
+
+    if (deviceSampleRate > 0.0)
+        for (int i = 0; i < count; ++i)
+            seekTrack (*tracks[i], position);
+
+    resumeTracks();
+}
+
+juce::int64 MultitrackMixer::getNextReadPosition() const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    return position;
+}
+
+juce::int64 MultitrackMixer::getTotalLength() const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    juce::int64 longest = 0;
+    for (int i = 0; i < numTracks.load(); ++i)
+        longest = juce::jmax (longest, tracks[i]->length);
+
+    return longest;
+}
+
+//==============================================================================
+// Track helpers
+
+juce::int64 MultitrackMixer::getOutputLength (const Track& track, double sampleRate)
+{
+    return (juce::int64) std::round ((double) track.fileLength * sampleRate / track.fileSampleRate);
+}
+
+// Sets up the decoder for sampleRate, with the track's reader stopped. Doesn't touch
+// track.length, which other threads read under the lock.
+void MultitrackMixer::prepareTrack (Track& track, double sampleRate)
+{
+    jassert (! track.reading);
+
+    const double ratio = track.fileSampleRate / sampleRate;
+
+    if (std::abs (ratio - 1.0) > 1.0e-9)
+    {
+        if (track.resampler == nullptr)
+            track.resampler = std::make_unique<juce::ResamplingAudioSource> (track.source.get(), false, 2);
+
+        track.resampler->setResamplingRatio (ratio);
+        track.decoder = track.resampler.get();
+    }
+    else
+    {
+        track.resampler.reset();
+        track.decoder = track.source.get();
+    }
+
+    // The reader decodes a chunk at a time; ResamplingAudioSource prepares its input with
+    // the scaled block size and rate
+    track.decoder->prepareToPlay (chunkSamples, sampleRate);
+}
+
+// Restarts the track's reader at newPosition, with the reader stopped and the audio thread
+// off the track. The first chunk is decoded here, so the track doesn't start with a gap.
+void MultitrackMixer::seekTrack (Track& track, juce::int64 newPosition)
+{
+    jassert (! track.reading);
+
+    const auto clamped = juce::jlimit ((juce::int64) 0, track.length, newPosition);
+    const double ratio = track.length > 0 ? (double) track.fileLength / (double) track.length : 1.0;
+
+    track.source->setNextReadPosition ((juce::int64) std::round ((double) clamped * ratio));
+
+    if (track.resampler != nullptr)
+        track.resampler->flushBuffers();
+
+    track.fifo.reset();
+    track.readPosition = track.writePosition = clamped;
+
+    track.readChunk();
+    track.startReading();
+}
+
+// Keeps the audio thread and the readers off every track (trackLock held); returns the
+// number of tracks
+int MultitrackMixer::suspendTracks()
+{
+    int count;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        suspended = true;
+        count = numTracks.load();
+    }
+
+    for (int i = 0; i < count; ++i)
+        tracks[i]->stopReading();
+
+    return count;
+}
+
+// Puts the tracks back on the audio thread; they stay off while the mixer is released
+void MultitrackMixer::resumeTracks()
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    suspended = deviceSampleRate <= 0.0;
+}
+
+//==============================================================================
+// Track reader
+
+int MultitrackMixer::Track::useTimeSlice()
+{
+    if (! readChunk())
+        return 20; // FIFO full or file finished: come back later
+
+    return fifo.getFreeSpace() >= chunkSamples ? 0 : 5;
+}
+
+// Decodes the next chunk into the FIFO if there is room for all of it
+bool MultitrackMixer::Track::readChunk()
+{
+    const int n = (int) juce::jmin ((juce::int64) chunkSamples, length - writePosition);
+
+    if (n <= 0 || fifo.getFreeSpace() < n)
+        return false;
+
+    decoder->getNextAudioBlock (juce::AudioSourceChannelInfo (&decodeBuffer, 0, n));
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (n, start1, size1, start2, size2);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        if (size1 > 0)
+            fifoBuffer.copyFrom (ch, start1, decodeBuffer, ch, 0, size1);
+        if (size2 > 0)
+            fifoBuffer.copyFrom (ch, start2, decodeBuffer, ch, size1, size2);
+    }
+
+    fifo.finishedWrite (size1 + size2);
+    writePosition += n;
+    return true;
+}
+
+void MultitrackMixer::Track::startReading()
+{
+    if (! reading)
+    {
+        readerThread->addTimeSliceClient (this);
+        reading = true;
+    }
+}
+
+// Returns once a chunk being decoded is finished
+void MultitrackMixer::Track::stopReading()
+{
+    if (reading)
+    {
+        readerThread->removeTimeSliceClient (this);
+        reading = false;
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Multitrack streaming mixer: up to maxTracks files played in sync, each with its own
+// gain / pan / mute, summed into a master bus.
+//
+// Every track decodes ahead into its own lock-free FIFO (an AbstractFifo), filled by a
+// small pool of background reader threads. The audio thread only copies samples out of
+// the FIFOs: it never takes a lock a reader holds while decoding, so it never waits for
+// the disk or a decoder. A track whose reader falls behind plays silence for the missing
+// samples and catches up with the timeline once the reader has refilled it.
+// Positions are in output (device) samples on a shared timeline; the mixer is
+// positionable, so it plugs into an AudioTransportSource.
+//
+// Tracks stream straight from their files: no seek index is built for them (a mixer
+// full of compressed files would otherwise decode and rewrite every one of them).
+class MultitrackMixer : public juce::PositionableAudioSource
+{
+public:
+    static constexpr int maxTracks = 64;
+
+    explicit MultitrackMixer (juce::AudioFormatManager& formatManagerToUse);
+    ~MultitrackMixer() override;
+
+    // track management (message thread). Returns the track index, or -1 on failure.
+    int  addTrack (const juce::URL& url);
+    void removeAllTracks();
+    int  getNumTracks() const noexcept                   { return numTracks.load(); }
+    juce::String getTrackName (int trackIndex) const;
+
+    // per-track and master controls (any thread, picked up on the next block)
+    void setTrackGain (int trackIndex, float gain);
+    void setTrackPan  (int trackIndex, float pan);       // -1 (left) .. +1 (right)
+    void setTrackMute (int trackIndex, bool shouldMute);
+    void setMasterGain (float gain);
+
+    // Streaming load: bytes the track readers actually pulled from their files since the
+    // previous call, per second (message thread)
+    double getDiskBytesPerSecond();
+    juce::int64 getTotalBytesRead() const noexcept       { return bytesRead.load(); }
+
+    // Track blocks the audio thread found not fully decoded yet (played partly silent)
+    int getNumUnderruns() const noexcept                 { return underruns.load(); }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition (juce::int64 newPosition) override; // message thread
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override                      { return false; }
+
+private:
+    //==============================================================================
+    static constexpr int readAheadSamples = 32768;
+    static constexpr int chunkSamples = 4096; // decoded per reader time slice
+
+    // One file: its decoder, and the FIFO its reader thread decodes into
+    struct Track : public juce::TimeSliceClient
+    {
+        ~Track() override                                { stopReading(); }
+
+        // reader thread
+        int useTimeSlice() override;
+        bool readChunk();
+
+        // message thread, with the audio thread kept off the track
+        void startReading();
+        void stopReading();
+
+        juce::String name;
+        std::unique_ptr<juce::AudioFormatReaderSource> source;
+        std::unique_ptr<juce::ResamplingAudioSource> resampler; // only when file rate != device rate
+        juce::AudioSource* decoder = nullptr;                   // source or resampler
+        juce::TimeSliceThread* readerThread = nullptr;
+        bool reading = false;
+
+        double fileSampleRate = 0.0;
+        juce::int64 fileLength = 0;      // in file samples
+        juce::int64 length = 0;          // in output samples
+
+        // Decoded output samples. The reader thread writes at writePosition, the audio
+        // thread reads at readPosition (both on the timeline); a seek resets both while
+        // neither thread is on the track.
+        juce::AbstractFifo fifo { readAheadSamples };
+        juce::AudioBuffer<float> fifoBuffer { 2, readAheadSamples };
+        juce::AudioBuffer<float> decodeBuffer { 2, chunkSamples };
+        juce::int64 writePosition = 0;
+        juce::int64 readPosition = 0;
+
+        std::atomic<float> gain { 1.0f };
+        std::atomic<float> pan  { 0.0f };
+        std::atomic<bool>  muted { false };
+
+        // gains applied on the previous block, ramped from when the controls change
+        float lastGainL = 0.0f, lastGainR = 0.0f;
+    };
+
+    juce::AudioFormatManager& formatManager;
+    juce::OwnedArray<juce::TimeSliceThread> readerThreads;
+
+    // Track slots; the audio thread holds this for one block,
+    // the message thread only for pointer swaps (never during file I/O).
+    mutable juce::SpinLock lock;
+    std::unique_ptr<Track> tracks[maxTracks];
+    std::atomic<int> numTracks { 0 };
+
+    // Serialises the message-thread operations that work on the tracks unlocked (adding,
+    // removing, preparing, seeking); never taken on the audio thread.
+    juce::CriticalSection trackLock;
+    bool suspended = false; // tracks are being prepared or sought: the audio thread outputs silence
+    std::atomic<int> underruns { 0 };
+
+    std::atomic<juce::int64> bytesRead { 0 }; // by every track's reader, see CountingInputStream
+    juce::int64 lastBytesRead = 0;
+    double lastDiskCheckMs = 0.0;
+
+    juce::int64 position = 0;
+    double deviceSampleRate = 0.0;
+
+    std::atomic<float> masterGain { 1.0f };
+    float lastMasterGain = 1.0f;
+
+    juce::AudioBuffer<float> trackBuffer; // one track's block before it is mixed
+
+    static juce::int64 getOutputLength (const Track& track, double sampleRate);
+    static void prepareTrack (Track& track, double sampleRate);
+    static void seekTrack (Track& track, juce::int64 newPosition);
+    int suspendTracks();
+    void resumeTracks();
+    void mixTrack (Track& track, juce::AudioBuffer<float>& dest, int startSample, int numSamples);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultitrackMixer)
+};
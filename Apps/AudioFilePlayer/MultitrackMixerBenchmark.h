@@ -0,0 +1,150 @@
+#pragma once
+
+#include "MultitrackMixer.h"
+
+//==============================================================================
+// Cost of MultitrackMixer at 8, 32 and 64 tracks, played in real time the way a device
+// would pull it: time spent in the audio callback (average and worst block, as a share of
+// the block's duration), CPU of the whole process with the reader threads' decoding
+// included, the bytes per second the readers pulled from the files, and how many track
+// blocks weren't decoded in time.
+//
+// The tracks are 24-bit stereo WAVs written to a temp folder first, so they are likely
+// still in the OS cache: the disk figure is the rate playback demands, not what the drive
+// can deliver. Run by the Benchmarks console app.
+namespace MultitrackMixerBenchmark
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr double fileSeconds = 10.0;
+
+    struct Figures
+    {
+        double averageCallbackPercent = 0.0; // of the block's duration
+        double worstCallbackPercent = 0.0;
+        double processCpuPercent = 0.0;      // of one core, every thread of the process (std::clock: wall time on Windows)
+        double diskBytesPerSecond = 0.0;
+        int underruns = 0;
+    };
+
+    // numFiles noise tracks in folder; returns false if one couldn't be written
+    inline bool writeTestFiles (const juce::File& folder, int numFiles)
+    {
+        juce::WavAudioFormat wavFormat;
+        juce::AudioBuffer<float> block (2, 4096);
+        juce::Random rng (42);
+
+        for (int i = 0; i < numFiles; ++i)
+        {
+            auto file = folder.getChildFile ("track" + juce::String (i + 1) + ".wav");
+            std::unique_ptr<juce::FileOutputStream> out (file.createOutputStream());
+
+            if (out == nullptr)
+                return false;
+
+            std::unique_ptr<juce::AudioFormatWriter> writer (wavFormat.createWriterFor (out.get(), sampleRate, 2, 24, {}, 0));
+            if (writer == nullptr)
+                return false;
+
+            out.release(); // now owned by the writer
+
+            for (juce::int64 done = 0; done < (juce::int64) (fileSeconds * sampleRate); done += block.getNumSamples())
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int s = 0; s < block.getNumSamples(); ++s)
+                        block.setSample (ch, s, 0.25f * (rng.nextFloat() * 2.0f - 1.0f));
+
+                if (! writer->writeFromAudioSampleBuffer (block, 0, block.getNumSamples()))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Plays the first numTracks files of folder for seconds of real time
+    inline Figures measure (juce::AudioFormatManager& formatManager, const juce::File& folder,
+                            int numTracks, double seconds = 8.0)
+    {
+        MultitrackMixer mixer (formatManager);
+
+        for (int i = 0; i < numTracks; ++i)
+            mixer.addTrack (juce::URL (folder.getChildFile ("track" + juce::String (i + 1) + ".wav")));
+
+        mixer.prepareToPlay (blockSize, sampleRate);
+        mixer.setNextReadPosition (0);
+        juce::Thread::sleep (500); // lets the readers fill their buffers, as a transport's start-up would
+
+        juce::AudioBuffer<float> output (2, blockSize);
+        const juce::AudioSourceChannelInfo info (&output, 0, blockSize);
+
+        const double blockMs = 1000.0 * blockSize / sampleRate;
+        const int numBlocks = (int) (seconds * sampleRate / blockSize);
+
+        double totalCallbackMs = 0.0, worstCallbackMs = 0.0;
+        const auto startBytes = mixer.getTotalBytesRead();
+        const int startUnderruns = mixer.getNumUnderruns();
+        const auto startCpu = std::clock();
+        const auto startMs = juce::Time::getMillisecondCounterHiRes();
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const auto callbackStart = juce::Time::getHighResolutionTicks();
+            mixer.getNextAudioBlock (info);
+            const double callbackMs = 1000.0 * juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - callbackStart);
+
+            totalCallbackMs += callbackMs;
+            worstCallbackMs = juce::jmax (worstCallbackMs, callbackMs);
+
+            // the next block is due when a device would ask for it
+            const double dueMs = startMs + (b + 1) * blockMs;
+            while (juce::Time::getMillisecondCounterHiRes() < dueMs)
+                juce::Thread::sleep (1);
+        }
+
+        const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+        const double cpuMs = 1000.0 * (double) (std::clock() - startCpu) / CLOCKS_PER_SEC;
+
+        Figures figures;
+        figures.averageCallbackPercent = 100.0 * totalCallbackMs / (numBlocks * blockMs);
+        figures.worstCallbackPercent = 100.0 * worstCallbackMs / blockMs;
+        figures.processCpuPercent = 100.0 * cpuMs / elapsedMs;
+        figures.diskBytesPerSecond = (double) (mixer.getTotalBytesRead() - startBytes) * 1000.0 / elapsedMs;
+        figures.underruns = mixer.getNumUnderruns() - startUnderruns;
+
+        mixer.releaseResources();
+        return figures;
+    }
+
+    inline void logAll()
+    {
+        const int trackCounts[] = { 8, 32, 64 };
+
+        const auto folder = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                                .getNonexistentChildFile ("MultitrackMixerBenchmark", {}, false);
+
+        if (! folder.createDirectory() || ! writeTestFiles (folder, MultitrackMixer::maxTracks))
+        {
+            juce::Logger::writeToLog ("Multitrack mixer: couldn't write the test files to " + folder.getFullPathName());
+            folder.deleteRecursively();
+            return;
+        }
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        for (int numTracks : trackCounts)
+        {
+            const auto figures = measure (formatManager, folder, numTracks);
+
+            juce::String line;
+            line << "Multitrack mixer, " << numTracks << " tracks @ " << blockSize << " samples: callback "
+                 << figures.averageCallbackPercent << "% average, " << figures.worstCallbackPercent << "% worst block, process CPU "
+                 << figures.processCpuPercent << "%, disk " << figures.diskBytesPerSecond / (1024.0 * 1024.0) << " MB/s, "
+                 << figures.underruns << " track underruns";
+            juce::Logger::writeToLog (line);
+        }
+
+        folder.deleteRecursively();
+    }
+}
@@ -1,5 +1,36 @@
 #include "MainComponent.h"
 
+//==============================================================================
+// Tap patterns offered by tapPatternBox, laid out over one delay time (the loop length)
+static juce::Array<MultichannelDelay::Tap> makeTapPattern (int patternId, float delayMs)
+{
+    juce::Array<MultichannelDelay::Tap> taps;
+
+    switch (patternId)
+    {
+        case 2: // quarters, alternating sides, fading
+            for (int k = 1; k <= 4; ++k)
+                taps.add ({ delayMs * (float) k / 4.0f, 1.0f - 0.2f * (float) (k - 1), (k & 1) ? -0.6f : 0.6f });
+            break;
+
+        case 3: // dotted eighth feel: 3/8, 6/8, then the full time in the centre
+            taps.add ({ delayMs * 0.375f, 0.8f, -0.8f });
+            taps.add ({ delayMs * 0.75f,  0.6f,  0.8f });
+            taps.add ({ delayMs,          0.9f,  0.0f });
+            break;
+
+        case 4: // 16 steps sweeping left to right
+            for (int k = 1; k <= 16; ++k)
+                taps.add ({ delayMs * (float) k / 16.0f, std::pow (0.88f, (float) k), -1.0f + 2.0f * (float) (k - 1) / 15.0f });
+            break;
+
+        default: // single delay
+            break;
+    }
+
+    return taps;
+}
+
 //==============================================================================
 MainComponent::MainComponent()
 {
@@ -33,13 +64,13 @@ MainComponent::MainComponent()
     // Ranges and defaults
     delayTimeSlider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
     delayTimeSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 20);
-    delayTimeSlider.setRange (1.0, 2000.0, 1.0); // ms
-    delayTimeSlider.setValue (delayTimeMs);
+    delayTimeSlider.setRange (1.0, maxDelaySeconds * 1000.0, 1.0); // ms
+    delayTimeSlider.setValue (delay.getParameters().delayMs);
     
     feedbackSlider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
     feedbackSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 20);
     feedbackSlider.setRange (0.0, 0.95, 0.001);
-    feedbackSlider.setValue (feedback);
+    feedbackSlider.setValue (delay.getParameters().feedback);
 
     // Labels
     delayTimeLabel.attachToComponent (&delayTimeSlider, false);
@@ -56,28 +87,114 @@ MainComponent::MainComponent()
     // Slider callbacks
     delayTimeSlider.onValueChange = [this]
     {
-        delayTimeMs = (float) delayTimeSlider.getValue();
-        // Map ms to samples and clamp to current max
-        const int newDelaySamples = (int) std::round ((delayTimeMs * 0.001) * currentSampleRate);
-        DBG ("Delay time changed: " << delayTimeMs << " ms -> " << newDelaySamples << " samples");
-        
-        if (maxDelaySamples > 0) // maxDelaySeconds is set to 2 seconds.
-            delaySamples = juce::jlimit (1, juce::jmax (1, maxDelaySamples - 1), newDelaySamples);
-        else
-            delaySamples = juce::jmax (1, newDelaySamples);
+        delay.setDelayMs ((float) delayTimeSlider.getValue());
+        updateTapPattern(); // tap times follow the delay time
     };
 
     feedbackSlider.onValueChange = [this]
     {
-        feedback = (float) feedbackSlider.getValue();
+        delay.setFeedback ((float) feedbackSlider.getValue());
     };
 
+    // Stereo cross-feedback amount (CrossFeedback routing)
+    crossSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 20);
+    crossSlider.setRange (0.0, 1.0, 0.01);
+    crossSlider.setValue (delay.getParameters().crossFeedback, juce::dontSendNotification);
+    crossSlider.onValueChange = [this]
+    {
+        delay.setCrossFeedback ((float) crossSlider.getValue());
+    };
+    crossLabel.attachToComponent (&crossSlider, false);
+    crossLabel.setJustificationType (juce::Justification::centred);
+    addAndMakeVisible (crossSlider);
+    addAndMakeVisible (crossLabel);
+
+    routingBox.addItem ("Independent", 1);
+    routingBox.addItem ("Cross-feedback", 2);
+    routingBox.addItem ("Ping-pong", 3);
+    routingBox.onChange = [this]
+    {
+        const int sel = routingBox.getSelectedId();
+        delay.setRouting (sel == 3 ? MultichannelDelay::Routing::PingPong
+                        : sel == 2 ? MultichannelDelay::Routing::CrossFeedback
+                                   : MultichannelDelay::Routing::Independent);
+        crossSlider.setEnabled (sel == 2);
+    };
+    routingBox.setSelectedId (1);
+    addAndMakeVisible (routingBox);
+
+    // Chorus mix and number of voices
+    chorusMixSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 20);
+    chorusMixSlider.setRange (0.0, 1.0, 0.01);
+    chorusMixSlider.setValue (chorus.getParameters().mix, juce::dontSendNotification);
+    chorusMixSlider.onValueChange = [this] { updateChorusParameters(); };
+
+    chorusVoicesSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 20);
+    chorusVoicesSlider.setRange (2.0, (double) Chorus::maxVoices, 1.0);
+    chorusVoicesSlider.setValue (chorus.getParameters().numVoices, juce::dontSendNotification);
+    chorusVoicesSlider.onValueChange = [this] { updateChorusParameters(); };
+
+    chorusMixLabel.attachToComponent (&chorusMixSlider, false);
+    chorusVoicesLabel.attachToComponent (&chorusVoicesSlider, false);
+    chorusMixLabel.setJustificationType (juce::Justification::centred);
+    chorusVoicesLabel.setJustificationType (juce::Justification::centred);
+    addAndMakeVisible (chorusMixSlider);
+    addAndMakeVisible (chorusVoicesSlider);
+    addAndMakeVisible (chorusMixLabel);
+    addAndMakeVisible (chorusVoicesLabel);
+
+    // Reverb send (mix) and decay time
+    reverbMixSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 20);
+    reverbMixSlider.setRange (0.0, 1.0, 0.01);
+    reverbMixSlider.setValue (reverb.getParameters().mix, juce::dontSendNotification);
+    reverbMixSlider.onValueChange = [this] { updateReverbParameters(); };
+
+    reverbDecaySlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 20);
+    reverbDecaySlider.setRange (0.2, 10.0, 0.01);
+    reverbDecaySlider.setSkewFactorFromMidPoint (2.0);
+    reverbDecaySlider.setValue (reverb.getParameters().decaySeconds, juce::dontSendNotification);
+    reverbDecaySlider.onValueChange = [this] { updateReverbParameters(); };
+
+    reverbMixLabel.attachToComponent (&reverbMixSlider, false);
+    reverbDecayLabel.attachToComponent (&reverbDecaySlider, false);
+    reverbMixLabel.setJustificationType (juce::Justification::centred);
+    reverbDecayLabel.setJustificationType (juce::Justification::centred);
+    addAndMakeVisible (reverbMixSlider);
+    addAndMakeVisible (reverbDecaySlider);
+    addAndMakeVisible (reverbMixLabel);
+    addAndMakeVisible (reverbDecayLabel);
+
+    tapPatternBox.addItem ("Single delay", 1);
+    tapPatternBox.addItem ("Multi-tap: quarters", 2);
+    tapPatternBox.addItem ("Multi-tap: dotted", 3);
+    tapPatternBox.addItem ("Multi-tap: 16 steps", 4);
+    tapPatternBox.onChange = [this] { updateTapPattern(); };
+    tapPatternBox.setSelectedId (1);
+    addAndMakeVisible (tapPatternBox);
+
+    // Buffer size and format. Long delays at high sample rates get big (60 s of 8 channels
+    // at 96 kHz is over 180 MB as floats); the compact formats take 1/2 or 3/4 of that.
+    for (int seconds : { 2, 10, 30, 60 })
+        maxDelayBox.addItem ("Max " + juce::String (seconds) + " s", seconds);
+    maxDelayBox.setSelectedId ((int) maxDelaySeconds, juce::dontSendNotification);
+    maxDelayBox.onChange = [this] { updateDelayBuffer(); };
+    addAndMakeVisible (maxDelayBox);
+
+    storageBox.addItem ("32-bit float buffer", 1);
+    storageBox.addItem ("16-bit float buffer", 2);
+    storageBox.addItem ("24-bit packed buffer", 3);
+    storageBox.setSelectedId (1, juce::dontSendNotification);
+    storageBox.onChange = [this] { updateDelayBuffer(); };
+    addAndMakeVisible (storageBox);
+
+    addAndMakeVisible (recorderControls);
+
     setButtonsEnabledState();
 
     juce::MessageManagerLock mmLock;
     transport.addChangeListener (this);
 
-    setAudioChannels (0, 1);
+    setAudioChannels (0, 2);
 }
 
 MainComponent::~MainComponent()
@@ -103,59 +220,65 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     currentSampleRate = sampleRate;
     transport.prepareToPlay (samplesPerBlockExpected, sampleRate);
 
-    // Prepare delay state
-    prepareDelayState();
+    int numOutChans = 1;
+    if (auto* dev = deviceManager.getCurrentAudioDevice())
+        numOutChans = juce::jmax (1, dev->getActiveOutputChannels().countNumberOfSetBits());
 
-    // Ensure delaySamples matches current delayTimeMs
-    delayTimeSlider.onValueChange();
+    // Prepare delay state: one write head per active output channel
+    prepareDelayState (numOutChans);
+    chorus.prepare (sampleRate, numOutChans);
+    reverb.prepare (sampleRate);
+
+    recorder.prepareToPlay (sampleRate, numOutChans);
 }
 
-void MainComponent::prepareDelayState()
+void MainComponent::prepareDelayState (int numChannels)
 {
-    // Choose a safe maximum delay time (in seconds)
-    const float maxDelaySeconds = 2.0f; // 2 seconds max delay
-    maxDelaySamples = (int) std::ceil (maxDelaySeconds * currentSampleRate);
-
-    delayBuffer.assign ((size_t) maxDelaySamples, 0.0f);
-    writePos = 0;
+    delay.prepare (currentSampleRate, numChannels, maxDelaySeconds, delayStorage);
 
-    // Clamp delaySamples to valid range
-    delaySamples = juce::jlimit (1, juce::jmax (1, maxDelaySamples - 1), delaySamples);
+    DBG ("Delay buffer: " << (double) delay.getMemoryBytes() / (1024.0 * 1024.0) << " MB");
 }
 
-void MainComponent::processDelayChannel (juce::AudioBuffer<float>& buffer, int channelNum)
+// The buffer is reallocated in prepareToPlay, so restart the device to apply a new
+// maximum delay or storage format (the audio thread never sees a half-built buffer)
+void MainComponent::updateDelayBuffer()
 {
-    if (buffer.getNumSamples() <= 0 || delayBuffer.empty())
-        return;
+    const int storageId = storageBox.getSelectedId();
+    delayStorage = storageId == 3 ? MultichannelDelay::Storage::Packed24
+                 : storageId == 2 ? MultichannelDelay::Storage::Float16
+                                  : MultichannelDelay::Storage::Float32;
 
-    if (channelNum < 0 || channelNum >= buffer.getNumChannels())
-        return;
+    maxDelaySeconds = (double) juce::jmax (1, maxDelayBox.getSelectedId());
 
-    auto* data = buffer.getWritePointer (channelNum);
-    const int numSamples = buffer.getNumSamples();
-    // delayBuffSize es constante, definido en funcion del maximo de delay permitido (2s.)
-    const int delayBuffSize = (int) delayBuffer.size();
+    delayTimeSlider.setRange (1.0, maxDelaySeconds * 1000.0, 1.0);
+    delayTimeSlider.setSkewFactorFromMidPoint (juce::jmin (1000.0, maxDelaySeconds * 250.0));
 
-    for (int i = 0; i < numSamples; ++i)
+    if (deviceManager.getCurrentAudioDevice() != nullptr)
     {
-        int readPos = writePos - delaySamples;
-        if (readPos < 0)
-            readPos += delayBuffSize;
-
-        const float delayed = delayBuffer[(size_t) readPos];
-        const float in      = data[i]; // read data from buffer
+        deviceManager.closeAudioDevice();
+        deviceManager.restartLastAudioDevice();
+    }
+}
 
-        delayBuffer[(size_t) writePos] = in + feedback * delayed;
+void MainComponent::updateTapPattern()
+{
+    delay.setTaps (makeTapPattern (tapPatternBox.getSelectedId(), (float) delayTimeSlider.getValue()));
+}
 
-        // Output write to streaming AudioBuffer: dry + wet (fixed 50/50)
-        data[i] = in + delayed;
-        //data[i] = delayed; /// Test only delay
+void MainComponent::updateChorusParameters()
+{
+    auto p = chorus.getParameters();
+    p.mix = (float) chorusMixSlider.getValue();
+    p.numVoices = (int) chorusVoicesSlider.getValue();
+    chorus.setParameters (p);
+}
 
-        // advance circular index (0-88199)
-        writePos = writePos + 1;
-        if (writePos == delayBuffSize)
-            writePos = 0;
-    }
+void MainComponent::updateReverbParameters()
+{
+    auto p = reverb.getParameters();
+    p.mix = (float) reverbMixSlider.getValue();
+    p.decaySeconds = (float) reverbDecaySlider.getValue();
+    reverb.setParameters (p);
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
@@ -169,22 +292,26 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
 
     transport.getNextAudioBlock (bufferToFill);
 
-    // Apply simple delay on a specific channel (current behavior: channel 0)
+    // Delay and chorus on every channel, then the reverb
     if (bufferToFill.buffer != nullptr && bufferToFill.numSamples > 0 && bufferToFill.buffer->getNumChannels() > 0)
     {
-        processDelayChannel (*bufferToFill.buffer, 0);
+        delay.process (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+        chorus.process (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+        reverb.process (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+        // Capture the processed output (lock-free hand-off to the writer thread)
+        recorder.pushBlock (*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
     }
-        
 }
 
 void MainComponent::releaseResources()
 {
     transport.releaseResources();
 
-    // Clear delay buffers
-    delayBuffer.clear();
-    writePos = 0;
-    maxDelaySamples = 0;
+    // Clear delay, chorus and reverb buffers
+    delay.release();
+    chorus.release();
+    reverb.release();
 }
 
 //==============================================================================
@@ -205,12 +332,25 @@ void MainComponent::resized()
     playButton.setBounds (row.removeFromLeft (120));
     row.removeFromLeft (10);
     stopButton.setBounds (row.removeFromLeft (120));
+    row.removeFromLeft (20);
+    recorderControls.setBounds (row);
 
     area.removeFromTop (20);
 
-    // Below: two rotary sliders in a row (time, feedback)
+    // Below: routing, tap pattern and buffer selectors, then the rotary sliders in a row
+    // (time, feedback, cross, chorus, voices, reverb, decay)
+    auto selectorRow = area.removeFromTop (28);
+    routingBox.setBounds (selectorRow.removeFromLeft (200));
+    selectorRow.removeFromLeft (10);
+    tapPatternBox.setBounds (selectorRow.removeFromLeft (200));
+    selectorRow.removeFromLeft (10);
+    maxDelayBox.setBounds (selectorRow.removeFromLeft (120));
+    selectorRow.removeFromLeft (10);
+    storageBox.setBounds (selectorRow.removeFromLeft (200));
+    area.removeFromTop (30);
+
     auto controlsArea = area.removeFromTop (200);
-    auto numKnobs = 2;
+    auto numKnobs = 7;
     auto knobWidth = controlsArea.getWidth() / numKnobs;
 
     auto placeKnob = [] (juce::Component& c, juce::Rectangle<int> r)
@@ -225,6 +365,21 @@ void MainComponent::resized()
 
     col = controlsArea.removeFromLeft (knobWidth);
     placeKnob (feedbackSlider, col);
+
+    col = controlsArea.removeFromLeft (knobWidth);
+    placeKnob (crossSlider, col);
+
+    col = controlsArea.removeFromLeft (knobWidth);
+    placeKnob (chorusMixSlider, col);
+
+    col = controlsArea.removeFromLeft (knobWidth);
+    placeKnob (chorusVoicesSlider, col);
+
+    col = controlsArea.removeFromLeft (knobWidth);
+    placeKnob (reverbMixSlider, col);
+
+    col = controlsArea.removeFromLeft (knobWidth);
+    placeKnob (reverbDecaySlider, col);
 }
 
 void MainComponent::chooseAndLoadFile()
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../Utils/Audio/ThreadedRecorder.h"
+#include "../../../Utils/DSP/Chorus.h"
+#include "../../../Utils/DSP/FdnReverb.h"
+#include "MultichannelDelay.h"
 
 //==============================================================================
 /*
@@ -43,6 +47,30 @@ private:
     juce::Slider feedbackSlider  { juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
     juce::Label  feedbackLabel   { {}, "Feedback" };
 
+    juce::Slider crossSlider     { juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
+    juce::Label  crossLabel      { {}, "Cross" };
+
+    juce::Slider chorusMixSlider    { juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
+    juce::Label  chorusMixLabel     { {}, "Chorus" };
+
+    juce::Slider chorusVoicesSlider { juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
+    juce::Label  chorusVoicesLabel  { {}, "Voices" };
+
+    juce::Slider reverbMixSlider   { juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
+    juce::Label  reverbMixLabel    { {}, "Reverb" };
+
+    juce::Slider reverbDecaySlider { juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
+    juce::Label  reverbDecayLabel  { {}, "Decay (s)" };
+
+    juce::ComboBox routingBox;
+    juce::ComboBox tapPatternBox; // single delay or a multi-tap pattern over the delay time
+    juce::ComboBox maxDelayBox;   // longest delay time: sets the buffer size
+    juce::ComboBox storageBox;    // sample format of the delay buffer
+
+    // Output capture
+    ThreadedRecorder recorder;
+    RecorderControls recorderControls { recorder };
+
     // ChangeListener (to observe transport state changes)
     void changeListenerCallback (juce::ChangeBroadcaster* source) override;
 
@@ -52,22 +80,23 @@ private:
     void setButtonsEnabledState();
 
     //==============================================================================
-    // Simple mono delay state (channel 0 only)
-    // Parameters
-    float delayTimeMs   = 400.0f;  // delay time in milliseconds (mapped to delaySamples)
-    float feedback      = 0.35f;   // 0..<1
-
-    // Delay buffer (single channel)
-    std::vector<float> delayBuffer;
-    int writePos = 0;
-    int delaySamples = 22050;      // default (0.5s @ 44.1kHz); clamped in prepare
-
-    // Limits and rate
-    int maxDelaySamples = 0;
+    // Delay on every output channel (see MultichannelDelay); the controls publish
+    // its parameters, the audio thread picks them up once per block
+    MultichannelDelay delay;
+
+    // Chorus after the delay (every channel), then the reverb (first two channels)
+    Chorus chorus;
+    FdnReverb<16> reverb;
     double currentSampleRate = 44100.0;
 
-    void prepareDelayState();
-    void processDelayChannel (juce::AudioBuffer<float>& buffer, int channelNum);
+    double maxDelaySeconds = 2.0;
+    MultichannelDelay::Storage delayStorage = MultichannelDelay::Storage::Float32;
+
+    void prepareDelayState (int numChannels);
+    void updateDelayBuffer();
+    void updateTapPattern();
+    void updateChorusParameters();
+    void updateReverbParameters();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
@@ -0,0 +1,332 @@
+#include "MultichannelDelay.h"
+
+void MultichannelDelay::prepare (double sampleRate, int numChans, double maxDelaySeconds, Storage storageToUse)
+{
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    numChannels = juce::jlimit (1, maxChannels, numChans);
+    stride = numChannels <= 4 ? 4 : 8;
+
+    // switching format: drop the previous buffer
+    release();
+    storage = storageToUse;
+
+    const auto maxDelaySamples = (int) std::ceil (juce::jlimit (0.001, maxDelayLimitSeconds, maxDelaySeconds) * currentSampleRate);
+    const auto& p = params.read();
+
+    withLine ([&] (auto& line)
+    {
+        line.prepare (maxDelaySamples, numChannels, stride);
+        line.setSmoothingTime (currentSampleRate, 0.05);
+        line.setDelay ((float) juce::roundToInt (p.delayMs * 0.001 * currentSampleRate), true);
+    });
+
+    feedbackSmoother.reset (currentSampleRate, 0.05);
+    feedbackSmoother.setCurrentAndTargetValue (p.feedback);
+
+    tapMix.allocate ((size_t) tapChunkSize * (size_t) stride, true);
+    tapsNeedUpdate = true; // tap times depend on the sample rate
+}
+
+void MultichannelDelay::release()
+{
+    lineFloat32.release();
+    lineFloat16.release();
+    linePacked24.release();
+    tapMix.free();
+}
+
+size_t MultichannelDelay::getMemoryBytes() const noexcept
+{
+    return lineFloat32.getMemoryBytes() + lineFloat16.getMemoryBytes() + linePacked24.getMemoryBytes();
+}
+
+void MultichannelDelay::setTaps (const juce::Array<Tap>& newTaps) noexcept
+{
+    tapList.update ([&newTaps] (TapList& list)
+    {
+        list.numTaps = juce::jmin (maxTaps, newTaps.size());
+
+        for (int k = 0; k < list.numTaps; ++k)
+            list.taps[k] = newTaps.getReference (k);
+
+        ++list.version;
+    });
+}
+
+void MultichannelDelay::reset() noexcept
+{
+    withLine ([] (auto& line) { line.reset(); });
+}
+
+//==============================================================================
+void MultichannelDelay::updateRouting (const Parameters& p, int numChans) noexcept
+{
+    const auto mode = p.routing;
+    const float cross = mode == Routing::Independent ? 0.0f
+                      : mode == Routing::PingPong    ? 1.0f
+                                                     : p.crossFeedback;
+
+    identityRouting = mode != Routing::PingPong && cross == 0.0f;
+
+    for (int lane = 0; lane < maxChannels; ++lane)
+    {
+        // pairs (0,1), (2,3)...; an unpaired last channel (or padding lane) is its own partner
+        const int other = lane ^ 1;
+        partner[lane] = other < numChans && lane < numChans ? other : lane;
+
+        fbSelf[lane]  = 1.0f - cross;
+        fbCross[lane] = cross;
+
+        if (mode == Routing::PingPong)
+        {
+            // the pair's input (summed to mono) enters the first channel only
+            const bool first = (lane & 1) == 0;
+            inSelf[lane]  = first ? (partner[lane] == lane ? 1.0f : 0.5f) : 0.0f;
+            inCross[lane] = first && partner[lane] != lane ? 0.5f : 0.0f;
+        }
+        else
+        {
+            inSelf[lane]  = 1.0f;
+            inCross[lane] = 0.0f;
+        }
+    }
+}
+
+void MultichannelDelay::updateTaps (const TapList& list, int numChans, int maxDelaySamples) noexcept
+{
+    numActiveTaps = juce::jlimit (0, maxTaps, list.numTaps);
+    minTapDelay = tapChunkSize;
+
+    for (int k = 0; k < numActiveTaps; ++k)
+    {
+        const auto& tap = list.taps[k];
+
+        // Integer positions: a tap read is a plain frame load, no interpolation
+        tapDelay[k] = juce::jlimit (1, maxDelaySamples,
+                                    juce::roundToInt (tap.delayMs * 0.001 * currentSampleRate));
+        minTapDelay = juce::jmin (minTapDelay, tapDelay[k]);
+
+        // Constant-power pan across each pair; an unpaired channel gets the plain gain
+        const float angle = (juce::jlimit (-1.0f, 1.0f, tap.pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+        const float first = tap.gain * std::cos (angle);
+        const float second = tap.gain * std::sin (angle);
+
+        for (int lane = 0; lane < maxChannels; ++lane)
+            tapGains[k][lane] = lane >= numChans        ? 0.0f
+                              : (lane ^ 1) >= numChans  ? tap.gain
+                              : (lane & 1) == 0         ? first
+                                                        : second;
+    }
+
+    tapListVersion = list.version;
+    tapNumChans = numChans;
+    tapsNeedUpdate = false;
+}
+
+void MultichannelDelay::process (juce::AudioBuffer<float>& audio, int startSample, int numSamples) noexcept
+{
+    if (getMemoryBytes() == 0 || numSamples <= 0)
+        return;
+
+    const int numChans = juce::jmin (numChannels, audio.getNumChannels());
+    if (numChans <= 0)
+        return;
+
+    float* channels[maxChannels] {};
+    for (int ch = 0; ch < numChans; ++ch)
+        channels[ch] = audio.getWritePointer (ch, startSample);
+
+    // One consistent snapshot per block; time and feedback ramp from here per sample
+    const auto& p = params.read();
+    updateRouting (p, numChans);
+    feedbackSmoother.setTargetValue (p.feedback);
+
+    withLine ([&] (auto& line) { processLine (line, channels, numChans, numSamples, p.delayMs); });
+}
+
+template <typename Line>
+void MultichannelDelay::processLine (Line& line, float* const* channels, int numChans, int numSamples, float delayMs) noexcept
+{
+    // Integer delay: once the ramp settles the read is exact and the span path applies
+    line.setDelay ((float) juce::roundToInt (delayMs * 0.001 * currentSampleRate));
+
+    const auto& taps = tapList.read();
+    if (tapsNeedUpdate || taps.version != tapListVersion || numChans != tapNumChans)
+        updateTaps (taps, numChans, line.getMaximumDelayInSamples());
+
+    if (numActiveTaps == 0)
+        processChunk (line, channels, numChans, numSamples, 1.0f);
+    else if (stride == 4)
+        processWithTaps<4> (line, channels, numChans, numSamples);
+    else
+        processWithTaps<8> (line, channels, numChans, numSamples);
+}
+
+template <typename Line>
+void MultichannelDelay::processChunk (Line& line, float* const* channels, int numChans, int numSamples, float wetGain) noexcept
+{
+    const int blockDelay = (int) line.getTargetDelay();
+
+    if (! line.isSmoothing() && ! feedbackSmoother.isSmoothing() && line.canProcessSpans (blockDelay, numSamples))
+    {
+        if (stride == 4)
+            processBlockSpans<4> (line, channels, numChans, numSamples, blockDelay, wetGain);
+        else
+            processBlockSpans<8> (line, channels, numChans, numSamples, blockDelay, wetGain);
+    }
+    else
+    {
+        // ramping, or a delay shorter than the block: frame by frame
+        if (stride == 4)
+            processFrames<4> (line, channels, numChans, numSamples, wetGain);
+        else
+            processFrames<8> (line, channels, numChans, numSamples, wetGain);
+    }
+}
+
+template <int Stride, typename Line>
+void MultichannelDelay::processWithTaps (Line& line, float* const* channels, int numChans, int numSamples) noexcept
+{
+    // Chunks no longer than the shortest tap: everything a chunk's taps read was written
+    // before the chunk, so they can all be gathered up front
+    for (int done = 0; done < numSamples;)
+    {
+        const int n = juce::jmin (numSamples - done, minTapDelay);
+
+        gatherTaps<Stride> (line, n);
+
+        float* chunk[maxChannels] {};
+        for (int ch = 0; ch < numChans; ++ch)
+            chunk[ch] = channels[ch] + done;
+
+        // feedback loop as usual, but only the dry signal goes to the output...
+        processChunk (line, chunk, numChans, n, 0.0f);
+
+        // ...plus the taps
+        for (int ch = 0; ch < numChans; ++ch)
+        {
+            const float* mix = tapMix.get() + ch;
+            float* out = chunk[ch];
+
+            for (int j = 0; j < n; ++j)
+                out[j] += mix[j * Stride];
+        }
+
+        done += n;
+    }
+}
+
+template <int Stride, typename Line>
+void MultichannelDelay::gatherTaps (Line& line, int numSamples) noexcept
+{
+    jassert (numSamples <= tapChunkSize);
+
+    float* mix = tapMix.get();
+    juce::FloatVectorOperations::clear (mix, numSamples * Stride);
+
+    for (int k = 0; k < numActiveTaps; ++k)
+    {
+        // local copy: lets the compiler keep the gains in a register
+        alignas (32) float gains[Stride];
+        for (int lane = 0; lane < Stride; ++lane)
+            gains[lane] = tapGains[k][lane];
+
+        line.readSpans (tapDelay[k], numSamples, [&] (const float* frames, int offset, int numFrames)
+        {
+            float* dest = mix + offset * Stride;
+
+            // One frame per step, all lanes at once: fixed trip count, vectorised
+            for (int j = 0; j < numFrames; ++j)
+                for (int lane = 0; lane < Stride; ++lane)
+                    dest[j * Stride + lane] += gains[lane] * frames[j * Stride + lane];
+        });
+    }
+}
+
+template <int Stride>
+void MultichannelDelay::mixFrame (const float* in, const float* delayed, float* writeFrame, float fb) const noexcept
+{
+    alignas (32) float inSwapped[Stride];
+    alignas (32) float delayedSwapped[Stride];
+
+    for (int lane = 0; lane < Stride; ++lane)
+    {
+        inSwapped[lane]      = in[partner[lane]];
+        delayedSwapped[lane] = delayed[partner[lane]];
+    }
+
+    // One frame of all channels at once: fixed trip count, no branches
+    for (int lane = 0; lane < Stride; ++lane)
+        writeFrame[lane] = inSelf[lane] * in[lane] + inCross[lane] * inSwapped[lane]
+                         + fb * (fbSelf[lane] * delayed[lane] + fbCross[lane] * delayedSwapped[lane]);
+}
+
+template <int Stride, typename Line>
+void MultichannelDelay::processFrames (Line& line, float* const* channels, int numChans, int numSamples, float wetGain) noexcept
+{
+    alignas (32) float in[Stride] {};        // padding lanes stay silent
+    alignas (32) float delayed[Stride] {};
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float fb = feedbackSmoother.getNextValue();
+        line.readFrame (line.getNextDelay(), delayed);
+
+        for (int ch = 0; ch < numChans; ++ch)
+            in[ch] = channels[ch][i];
+
+        mixFrame<Stride> (in, delayed, line.getWriteFrame(), fb);
+
+        // Output: dry + wet (fixed 50/50; no wet when taps make the output)
+        for (int ch = 0; ch < numChans; ++ch)
+            channels[ch][i] = in[ch] + wetGain * delayed[ch];
+
+        line.advance();
+    }
+}
+
+template <int Stride, typename Line>
+void MultichannelDelay::processBlockSpans (Line& line, float* const* channels, int numChans, int numSamples, int delaySamples, float wetGain) noexcept
+{
+    const float fb = feedbackSmoother.getTargetValue(); // not ramping on this path
+
+    line.processSpans (delaySamples, numSamples, [&] (const float* readFrames, float* writeFrames, int offset, int numFrames)
+    {
+        if (identityRouting)
+        {
+            // Feedback for every lane of the span in one vector op, then add the input
+            juce::FloatVectorOperations::copyWithMultiply (writeFrames, readFrames, fb, numFrames * Stride);
+
+            for (int ch = 0; ch < numChans; ++ch)
+            {
+                float* io = channels[ch] + offset;
+                const float* delayed = readFrames + ch;
+                float* written = writeFrames + ch;
+
+                for (int j = 0; j < numFrames; ++j)
+                {
+                    const float in = io[j];
+                    written[j * Stride] += in;
+                    io[j] = in + wetGain * delayed[j * Stride]; // dry + wet (fixed 50/50)
+                }
+            }
+        }
+        else
+        {
+            alignas (32) float in[Stride] {};
+
+            for (int j = 0; j < numFrames; ++j)
+            {
+                const float* delayed = readFrames + j * Stride;
+
+                for (int ch = 0; ch < numChans; ++ch)
+                    in[ch] = channels[ch][offset + j];
+
+                mixFrame<Stride> (in, delayed, writeFrames + j * Stride, fb);
+
+                for (int ch = 0; ch < numChans; ++ch)
+                    channels[ch][offset + j] = in[ch] + wetGain * delayed[ch];
+            }
+        }
+    });
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../../Utils/DSP/DelayLine.h"
+#include "../../../Utils/DSP/RealtimeParams.h"
+
+//==============================================================================
+// Delay for every output channel, each with its own write head.
+//
+// The buffer (a DelayLine) is stored channel-interleaved: one frame holds the samples of
+// all channels at the same time index, padded to a stride of 4 or 8 floats. Reading a tap
+// is then one contiguous load per frame and the per-channel math runs over fixed-size
+// lanes the compiler vectorises, so 1 to 4 channels (and 5 to 8) cost the same.
+// Parameters are published as one snapshot (RealtimeParams) and read once per block; the
+// delay time is read fractionally and, like the feedback, ramps to new values per sample,
+// so moving a control doesn't click.
+// Once the ramps have settled and the delay is at least one block long, the block is done
+// span by span (see DelayLine::processSpans) instead of frame by frame.
+//
+// Routing:
+//   Independent   - every channel feeds back into itself
+//   CrossFeedback - pairs (0,1), (2,3)... feed part of their echo into each other
+//   PingPong      - each pair's input goes into the first channel and the echoes
+//                   bounce between the two
+//
+// Multi-tap: with a tap list set (up to maxTaps of time/gain/pan), the output is the dry
+// signal plus the sum of the taps instead of the single delayed signal; the main delay time
+// and feedback still set the loop the pattern repeats on. All taps read the same buffer.
+// Tap positions and per-lane gains are rebuilt only when the list changes, and taps are
+// gathered a chunk at a time: per tap, a multiply-add over whole frames (4 or 8 lanes).
+//
+// Storage: for long maximum delays the buffer can be kept as 16-bit floats or packed
+// 24-bit samples (see DelayLineStorage): 1/2 or 3/4 of the memory of 32-bit floats.
+class MultichannelDelay
+{
+public:
+    enum class Routing { Independent, CrossFeedback, PingPong };
+    enum class Storage { Float32, Float16, Packed24 };
+
+    static constexpr int maxChannels = 8;
+    static constexpr double maxDelayLimitSeconds = 60.0;
+
+    struct Parameters
+    {
+        float delayMs = 400.0f;
+        float feedback = 0.35f;       // 0..0.99
+        float crossFeedback = 0.5f;   // 0..1, CrossFeedback routing only
+        Routing routing = Routing::Independent;
+    };
+
+    static constexpr int maxTaps = 64;
+
+    struct Tap
+    {
+        float delayMs = 0.0f;
+        float gain = 1.0f;
+        float pan = 0.0f;             // -1 (first channel of a pair) .. 1 (second)
+    };
+
+    MultichannelDelay() = default;
+
+    // message thread (audio stopped): allocates the buffer (maxDelaySeconds up to maxDelayLimitSeconds)
+    void prepare (double sampleRate, int numChannels, double maxDelaySeconds, Storage storageToUse = Storage::Float32);
+    void release();
+    void reset() noexcept;
+
+    // message thread (a single writer): each call publishes a complete new Parameters
+    void setDelayMs (float newDelayMs) noexcept         { params.update ([=] (Parameters& p) { p.delayMs = newDelayMs; }); }
+    void setFeedback (float newFeedback) noexcept       { params.update ([=] (Parameters& p) { p.feedback = juce::jlimit (0.0f, 0.99f, newFeedback); }); }
+    void setCrossFeedback (float amount) noexcept       { params.update ([=] (Parameters& p) { p.crossFeedback = juce::jlimit (0.0f, 1.0f, amount); }); }
+    void setRouting (Routing newRouting) noexcept       { params.update ([=] (Parameters& p) { p.routing = newRouting; }); }
+
+    // message thread: replaces the tap list (extra taps beyond maxTaps are ignored);
+    // an empty list goes back to the single delay output
+    void setTaps (const juce::Array<Tap>& newTaps) noexcept;
+
+    // message thread: the values last set (for initialising controls)
+    const Parameters& getParameters() const noexcept    { return params.getLastWritten(); }
+
+    int getNumChannels() const noexcept                 { return numChannels; }
+    Storage getStorage() const noexcept                 { return storage; }
+    size_t getMemoryBytes() const noexcept;
+
+    // audio thread: processes the first getNumChannels() channels in place
+    void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    // The processing code is written once against whichever line is in use
+    template <typename Line>
+    void processLine (Line& line, float* const* channels, int numChans, int numSamples, float delayMs) noexcept;
+
+    template <typename Line>
+    void processChunk (Line& line, float* const* channels, int numChans, int numSamples, float wetGain) noexcept;
+
+    template <int Stride, typename Line>
+    void processFrames (Line& line, float* const* channels, int numChans, int numSamples, float wetGain) noexcept;
+
+    template <int Stride, typename Line>
+    void processBlockSpans (Line& line, float* const* channels, int numChans, int numSamples, int delaySamples, float wetGain) noexcept;
+
+    template <int Stride, typename Line>
+    void processWithTaps (Line& line, float* const* channels, int numChans, int numSamples) noexcept;
+
+    template <int Stride, typename Line>
+    void gatherTaps (Line& line, int numSamples) noexcept;
+
+    template <int Stride>
+    void mixFrame (const float* in, const float* delayed, float* writeFrame, float fb) const noexcept;
+
+    // One line per storage format; only the one selected in prepare() is allocated
+    DelayLine<float, DelayLineInterpolation::Linear> lineFloat32;
+    DelayLine<float, DelayLineInterpolation::Linear, DelayLineStorage::Float16> lineFloat16;
+    DelayLine<float, DelayLineInterpolation::Linear, DelayLineStorage::Packed24> linePacked24;
+    Storage storage = Storage::Float32;
+
+    template <typename Function>
+    void withLine (Function&& fn)
+    {
+        switch (storage)
+        {
+            case Storage::Float16:  fn (lineFloat16); break;
+            case Storage::Packed24: fn (linePacked24); break;
+            case Storage::Float32:
+            default:                fn (lineFloat32); break;
+        }
+    }
+
+    int stride = 4;
+    int numChannels = 0;
+    double currentSampleRate = 44100.0;
+
+    // per-lane routing, rebuilt once per block
+    int partner[maxChannels] {};
+    float inSelf[maxChannels] {}, inCross[maxChannels] {};
+    float fbSelf[maxChannels] {}, fbCross[maxChannels] {};
+    bool identityRouting = true; // Independent: every lane only feeds itself
+
+    RealtimeParams<Parameters> params;
+    juce::SmoothedValue<float> feedbackSmoother { 0.35f };
+
+    void updateRouting (const Parameters& p, int numChans) noexcept;
+
+    // Tap list (message thread -> audio thread); version changes on every setTaps()
+    struct TapList
+    {
+        int numTaps = 0;
+        juce::uint32 version = 0;
+        Tap taps[maxTaps];
+    };
+
+    RealtimeParams<TapList> tapList;
+
+    // audio thread: tap read positions and per-lane gains, rebuilt when the list changes
+    static constexpr int tapChunkSize = 256;   // frames gathered at a time (tapMix size)
+    int numActiveTaps = 0;
+    int tapDelay[maxTaps] {};
+    int minTapDelay = tapChunkSize;
+    alignas (32) float tapGains[maxTaps][maxChannels] {};
+    juce::HeapBlock<float> tapMix;             // tapChunkSize frames of `stride` floats
+    juce::uint32 tapListVersion = 0;
+    int tapNumChans = 0;
+    bool tapsNeedUpdate = true;
+
+    void updateTaps (const TapList& list, int numChans, int maxDelaySamples) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultichannelDelay)
+};
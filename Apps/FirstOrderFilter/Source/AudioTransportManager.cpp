@@ -3,23 +3,26 @@
 AudioTransportManager::AudioTransportManager()
 {
     formatManager.registerBasicFormats();
+
+    // The playlist resamples each file to the device rate itself, so no rate correction here
+    transport.setSource (&playlist, 0, nullptr, 0.0);
 }
 
 AudioTransportManager::~AudioTransportManager()
 {
     transport.stop();
     transport.setSource (nullptr);
-    readerSource.reset();
 }
 
-void AudioTransportManager::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+void AudioTransportManager::prepareToPlay (int samplesPerBlockExpected, double sampleRate, int numOutputChannels)
 {
+    playlist.setNumOutputChannels (numOutputChannels);
     transport.prepareToPlay (samplesPerBlockExpected, sampleRate);
 }
 
 void AudioTransportManager::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    if (readerSource == nullptr)
+    if (! playlist.hasCurrentItem())
     {
         bufferToFill.clearActiveBufferRegion();
         return;
@@ -35,25 +38,43 @@ void AudioTransportManager::releaseResources()
 
 bool AudioTransportManager::loadURL (const juce::URL& url)
 {
+    // Loading a single file replaces the whole queue
     stop();
-    transport.setSource (nullptr);
-    readerSource.reset();
+    playlist.clearQueue();
+    playlist.addToQueue (url);
 
-    std::unique_ptr<juce::InputStream> inputStream (url.createInputStream (false));
-    if (inputStream == nullptr)
+    if (! playlist.startFromIndex (0))
         return false;
 
-    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (std::move (inputStream)));
-    if (reader == nullptr)
-        return false;
+    transport.setPosition (0.0);
+    return true;
+}
 
-    const double fileSampleRate = reader->sampleRate;
+void AudioTransportManager::enqueueURL (const juce::URL& url)
+{
+    if (! playlist.hasCurrentItem())
+    {
+        loadURL (url);
+        return;
+    }
 
-    readerSource.reset (new juce::AudioFormatReaderSource (reader.release(), true));
-    transport.setSource (readerSource.get(), 0, nullptr, fileSampleRate);
-    transport.setPosition (0.0);
+    // The next item is pre-rolled in the background while the current one plays
+    playlist.addToQueue (url);
+}
 
-    return true;
+int AudioTransportManager::getNumQueuedFiles() const
+{
+    return playlist.getNumQueuedItems();
+}
+
+void AudioTransportManager::setLooping (bool shouldLoop)
+{
+    playlist.setLooping (shouldLoop);
+}
+
+void AudioTransportManager::setCrossfadeSeconds (double seconds)
+{
+    playlist.setCrossfadeSeconds (seconds);
 }
 
 void AudioTransportManager::start()
@@ -68,6 +89,10 @@ void AudioTransportManager::stop()
 
 void AudioTransportManager::setPosition (double seconds)
 {
+    // Rewinding after the last queued file ended starts the queue over
+    if (seconds <= 0.0 && playlist.hasQueueFinished())
+        playlist.startFromIndex (0);
+
     transport.setPosition (seconds);
 }
 
@@ -83,7 +108,7 @@ bool AudioTransportManager::hasStreamFinished() const
 
 bool AudioTransportManager::hasFileLoaded() const
 {
-    return readerSource != nullptr;
+    return playlist.hasCurrentItem();
 }
 
 void AudioTransportManager::addChangeListener (juce::ChangeListener* listener)
@@ -114,3 +139,19 @@ void AudioTransportManager::chooseAndLoadFile()
         loadURL (url);
     });
 }
+
+void AudioTransportManager::chooseAndEnqueueFiles()
+{
+    auto chooser = std::make_shared<juce::FileChooser> ("Select audio files to queue...",
+                                                         juce::File(),
+                                                         "*.wav;*.aiff;*.mp3;*.flac;*.ogg;*.m4a");
+    auto flags = juce::FileBrowserComponent::openMode
+               | juce::FileBrowserComponent::canSelectFiles
+               | juce::FileBrowserComponent::canSelectMultipleItems;
+
+    chooser->launchAsync (flags, [this, chooser] (const juce::FileChooser& fc)
+    {
+        for (const auto& url : fc.getURLResults())
+            enqueueURL (url);
+    });
+}
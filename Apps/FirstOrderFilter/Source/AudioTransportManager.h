@@ -1,8 +1,10 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PlaylistAudioSource.h"
 
-// Encapsulates file loading and playback via AudioTransportSource
+// Encapsulates file loading and playback via AudioTransportSource.
+// Files are played through a gapless playlist queue (see PlaylistAudioSource).
 class AudioTransportManager
 {
 public:
@@ -10,7 +12,7 @@ public:
     ~AudioTransportManager();
 
     // lifecycle with device
-    void prepareToPlay (int samplesPerBlockExpected, double sampleRate);
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate, int numOutputChannels);
     void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill);
     void releaseResources();
 
@@ -18,6 +20,13 @@ public:
     void chooseAndLoadFile();
     bool loadURL (const juce::URL& url);
 
+    // playlist queue
+    void chooseAndEnqueueFiles();
+    void enqueueURL (const juce::URL& url);
+    int  getNumQueuedFiles() const;
+    void setLooping (bool shouldLoop);
+    void setCrossfadeSeconds (double seconds);
+
     // transport controls
     void start();
     void stop();
@@ -32,6 +41,7 @@ public:
     
     juce::ChangeBroadcaster* getTransportBroadcaster() { return &transport; }
     juce::AudioTransportSource* getTransport() { return &transport; }
+    juce::AudioFormatManager& getFormatManager() { return formatManager; }
 
 private:
     // forward transport state changes to our own broadcaster so MainComponent can listen via manager
@@ -39,7 +49,7 @@ private:
 
     juce::AudioFormatManager formatManager;
     juce::AudioTransportSource transport;
-    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
+    PlaylistAudioSource playlist { formatManager };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioTransportManager)
 };
@@ -9,6 +9,7 @@ MainComponent::MainComponent()
     addAndMakeVisible (loadButton);
     addAndMakeVisible (playButton);
     addAndMakeVisible (stopButton);
+    addAndMakeVisible (renderButton);
 
     loadButton.onClick = [this]
     {
@@ -23,6 +24,38 @@ MainComponent::MainComponent()
         audioManager.stop();
         setButtonsEnabledState();
     };
+    renderButton.onClick = [this]
+    {
+        chooseAndRenderFile();
+    };
+
+    // Playlist UI: queued files play back to back without gaps
+    addAndMakeVisible (queueButton);
+    addAndMakeVisible (loopToggle);
+
+    queueButton.onClick = [this]
+    {
+        audioManager.chooseAndEnqueueFiles();
+        playButton.setEnabled (true);
+    };
+    loopToggle.onClick = [this]
+    {
+        audioManager.setLooping (loopToggle.getToggleState());
+    };
+
+    crossfadeSlider.setSliderStyle (juce::Slider::SliderStyle::LinearHorizontal);
+    crossfadeSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 80, 20);
+    crossfadeSlider.setRange (0.0, 10.0, 0.01); // 0 = gapless cut
+    crossfadeSlider.setValue (0.0);
+    crossfadeSlider.onValueChange = [this]
+    {
+        audioManager.setCrossfadeSeconds (crossfadeSlider.getValue());
+    };
+    addAndMakeVisible (crossfadeSlider);
+
+    crossfadeLabel.setJustificationType (juce::Justification::centredLeft);
+    crossfadeLabel.attachToComponent (&crossfadeSlider, true);
+    addAndMakeVisible (crossfadeLabel);
 
     // Filter UI setup
     // Cutoff slider
@@ -59,6 +92,8 @@ MainComponent::MainComponent()
     filterTypeLabel.attachToComponent (&filterTypeBox, true);
     addAndMakeVisible (filterTypeLabel);
 
+    addAndMakeVisible (recorderControls);
+
     setButtonsEnabledState();
 
     // Listen for transport state changes via manager
@@ -84,7 +119,12 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     // reset state (size will be ensured on first getNextAudioBlock)
     prevValues.clearQuick();
 
-    audioManager.prepareToPlay (samplesPerBlockExpected, sampleRate);
+    int numOutChans = 2;
+    if (auto* dev = deviceManager.getCurrentAudioDevice())
+        numOutChans = juce::jmax (1, dev->getActiveOutputChannels().countNumberOfSetBits());
+
+    audioManager.prepareToPlay (samplesPerBlockExpected, sampleRate, numOutChans);
+    recorder.prepareToPlay (sampleRate, 2);
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
@@ -123,6 +163,9 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
                 data[n] = processSampleHP (data[n], ch);
         }
     }
+
+    // Capture the filtered output (lock-free hand-off to the writer thread)
+    recorder.pushBlock (*buffer, startSample, numSamples);
 }
 
 void MainComponent::releaseResources()
@@ -148,6 +191,25 @@ void MainComponent::resized()
     playButton.setBounds (row.removeFromLeft (120));
     row.removeFromLeft (10);
     stopButton.setBounds (row.removeFromLeft (120));
+    row.removeFromLeft (10);
+    queueButton.setBounds (row.removeFromLeft (120));
+    row.removeFromLeft (10);
+    loopToggle.setBounds (row.removeFromLeft (80));
+    row.removeFromLeft (10);
+    renderButton.setBounds (row.removeFromLeft (120));
+
+    area.removeFromTop (10);
+    recorderControls.setBounds (area.removeFromTop (28));
+
+    area.removeFromTop (10);
+
+    // Crossfade row (label attached to component)
+    {
+        auto crossfadeRow = area.removeFromTop (28);
+        auto labelWidth = 110;
+        crossfadeRow.removeFromLeft (labelWidth);
+        crossfadeSlider.setBounds (crossfadeRow);
+    }
 
     area.removeFromTop (20);
 
@@ -178,6 +240,45 @@ void MainComponent::chooseAndLoadFile()
     playButton.setEnabled(true);
 }
 
+void MainComponent::chooseAndRenderFile()
+{
+    if (renderer != nullptr && renderer->isThreadRunning())
+        return;
+
+    renderChooser = std::make_shared<juce::FileChooser> ("Select a file to render...",
+                                                         juce::File{},
+                                                         audioManager.getFormatManager().getWildcardForAllFormats());
+
+    renderChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                [this] (const juce::FileChooser& fc)
+    {
+        const auto input = fc.getResult();
+        if (input == juce::File{})
+            return;
+
+        renderChooser = std::make_shared<juce::FileChooser> ("Save filtered file as...",
+                                                             input.getSiblingFile (input.getFileNameWithoutExtension() + "_filtered.wav"),
+                                                             "*.wav");
+        auto flags = juce::FileBrowserComponent::saveMode
+                   | juce::FileBrowserComponent::canSelectFiles
+                   | juce::FileBrowserComponent::warnAboutOverwriting;
+
+        renderChooser->launchAsync (flags, [this, input] (const juce::FileChooser& saveChooser)
+        {
+            const auto output = saveChooser.getResult();
+            if (output == juce::File{} || output == input)
+                return;
+
+            // Current UI settings; the render runs on its own threads, independent of playback
+            const auto type = filterType.load() == FilterType::HighPass ? OfflineFilterRenderer::Type::HighPass
+                                                                        : OfflineFilterRenderer::Type::LowPass;
+            renderer = std::make_unique<OfflineFilterRenderer> (audioManager.getFormatManager(), input, output,
+                                                                type, cutoffHz.load());
+            renderer->launchThread();
+        });
+    });
+}
+
 void MainComponent::setButtonsEnabledState()
 {
     const bool hasFile = audioManager.hasFileLoaded();
@@ -219,13 +320,8 @@ void MainComponent::updateCoefficients()
 {
     // Low-pass: y[n] = a0 * x[n] + b1 * y[n-1],
     // High-pass (complement): y[n] = x[n] - LP(x[n])
-    auto sampleRate = currentSampleRate > 0.0 ? currentSampleRate : 44100.0;
-    // limita cutOffFreq entre 10hz y 45% del Sample Rate, cerca de Nyquist
-    auto cutOff = juce::jlimit (10.0f, (float) (0.45 * sampleRate), cutoffHz.load (std::memory_order_relaxed));
-    const double alpha = std::exp (-2.0 * juce::MathConstants<double>::pi * (double) cutOff / sampleRate);
-
-    a0 = (float) (1.0 - alpha);
-    b1 = (float) alpha;
+    // shared with the offline renderer so both paths use identical coefficients
+    OfflineFilterRenderer::computeCoefficients (cutoffHz.load (std::memory_order_relaxed), currentSampleRate, a0, b1);
 }
 
 inline float MainComponent::processSampleLP (float x, int ch)
@@ -2,6 +2,8 @@
 
 #include <JuceHeader.h>
 #include "AudioTransportManager.h"
+#include "OfflineFilterRenderer.h"
+#include "../../../Utils/Audio/ThreadedRecorder.h"
 
 //==============================================================================
 // This component lives inside our window, and this is where you should put all
@@ -32,6 +34,13 @@ private:
     juce::TextButton loadButton { "Load..." };
     juce::TextButton playButton { "Play" };
     juce::TextButton stopButton { "Stop" };
+    juce::TextButton renderButton { "Render..." };
+
+    // Playlist UI
+    juce::TextButton queueButton { "Queue..." };
+    juce::ToggleButton loopToggle { "Loop" };
+    juce::Slider crossfadeSlider;
+    juce::Label  crossfadeLabel { {}, "Crossfade (s)" };
 
     // New filter UI
     juce::Slider cutoffSlider;
@@ -40,11 +49,20 @@ private:
     juce::ComboBox filterTypeBox;
     juce::Label    filterTypeLabel { {}, "Filter Type" };
 
+    // Output capture
+    ThreadedRecorder recorder;
+    RecorderControls recorderControls { recorder };
+
+    // Offline render of a whole file with the current filter settings
+    std::shared_ptr<juce::FileChooser> renderChooser;
+    std::unique_ptr<OfflineFilterRenderer> renderer;
+
     // ChangeListener (to observe transport state changes)
     void changeListenerCallback (juce::ChangeBroadcaster* source) override;
 
     // Helpers
     void chooseAndLoadFile();
+    void chooseAndRenderFile();
     void setButtonsEnabledState();
 
     //==============================================================================
@@ -0,0 +1,208 @@
+#include "OfflineFilterRenderer.h"
+
+OfflineFilterRenderer::OfflineFilterRenderer (juce::AudioFormatManager& formatManagerToUse,
+                                              const juce::File& input, const juce::File& output,
+                                              Type filterType, float cutoff)
+    : juce::ThreadWithProgressWindow ("Rendering filtered file...", true, true),
+      formatManager (formatManagerToUse),
+      inputFile (input),
+      outputFile (output),
+      type (filterType),
+      cutoffHz (cutoff)
+{
+}
+
+OfflineFilterRenderer::~OfflineFilterRenderer()
+{
+    // The render thread has to finish before the pool goes: run() stops at the next job
+    // boundary and takes its queued jobs with it. Every step is bounded, so wait for it
+    // rather than have it killed.
+    stopThread (-1);
+    pool.removeAllJobs (true, -1);
+}
+
+void OfflineFilterRenderer::computeCoefficients (float cutoff, double sampleRate, float& a0, float& b1)
+{
+    sampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    // limita cutOffFreq entre 10hz y 45% del Sample Rate, cerca de Nyquist
+    const auto limited = juce::jlimit (10.0f, (float) (0.45 * sampleRate), cutoff);
+    const double alpha = std::exp (-2.0 * juce::MathConstants<double>::pi * (double) limited / sampleRate);
+
+    a0 = (float) (1.0 - alpha);
+    b1 = (float) alpha;
+}
+
+//==============================================================================
+bool OfflineFilterRenderer::runParallel (int numJobs, const std::function<void (int)>& job)
+{
+    std::atomic<int> remaining { numJobs };
+    juce::WaitableEvent allDone;
+
+    for (int i = 0; i < numJobs; ++i)
+    {
+        pool.addJob ([i, &job, &remaining, &allDone]
+        {
+            job (i);
+
+            if (--remaining == 0)
+                allDone.signal();
+        });
+    }
+
+    while (! allDone.wait (50))
+    {
+        if (threadShouldExit())
+        {
+            // the jobs use this frame's counter and event: drop the queued ones and wait
+            // for the running ones before leaving
+            pool.removeAllJobs (true, -1);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void OfflineFilterRenderer::run()
+{
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (inputFile));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return;
+
+    outputFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> out (outputFile.createOutputStream());
+    if (out == nullptr)
+        return;
+
+    // 32-bit float output: a high-passed signal can exceed the input's peak
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer (wavFormat.createWriterFor (out.get(), reader->sampleRate,
+                                                                                 reader->numChannels, 32, {}, 0));
+    if (writer == nullptr)
+        return;
+
+    out.release(); // now owned by the writer
+
+    float a0, b1;
+    computeCoefficients (cutoffHz, reader->sampleRate, a0, b1);
+
+    const int numChannels = (int) reader->numChannels;
+    const auto totalLength = reader->lengthInSamples;
+
+    juce::AudioBuffer<float> input (numChannels, segmentSize);   // x (kept for the HP complement)
+    juce::AudioBuffer<float> lowPass (numChannels, segmentSize); // y
+
+    // Per-channel filter state carried from one segment to the next (y[n-1])
+    std::vector<double> carriedState ((size_t) numChannels, 0.0);
+
+    const int maxChunks = juce::jmax (1, pool.getNumThreads());
+    std::vector<double> chunkEnd ((size_t) (numChannels * maxChunks));   // zero-state end value
+    std::vector<double> chunkStart ((size_t) (numChannels * maxChunks)); // true y before the chunk
+
+    for (juce::int64 pos = 0; pos < totalLength; pos += segmentSize)
+    {
+        if (threadShouldExit())
+            return;
+
+        const int numSamples = (int) juce::jmin ((juce::int64) segmentSize, totalLength - pos);
+        if (! reader->read (&input, 0, numSamples, pos, true, true))
+            return;
+
+        const int numChunks = juce::jlimit (1, maxChunks, numSamples / minChunkSize);
+        const int chunkSize = (numSamples + numChunks - 1) / numChunks;
+
+        auto chunkRange = [&] (int chunk)
+        {
+            const int start = chunk * chunkSize;
+            return juce::Range<int> (start, juce::jmin (numSamples, start + chunkSize));
+        };
+
+        // 1) every (channel, chunk) from a zero state, in parallel
+        const bool filtered = runParallel (numChannels * numChunks, [&] (int job)
+        {
+            const int ch = job / numChunks;
+            const auto range = chunkRange (job % numChunks);
+            const float* x = input.getReadPointer (ch);
+            float* y = lowPass.getWritePointer (ch);
+
+            float state = 0.0f;
+            for (int n = range.getStart(); n < range.getEnd(); ++n)
+            {
+                state = a0 * x[n] + b1 * state;
+                y[n] = state;
+            }
+
+            chunkEnd[(size_t) job] = state;
+        });
+
+        if (! filtered)
+            return;
+
+        // 2) carry the true state across chunk boundaries: s_k = end_k + b1^len_k * s_(k-1)
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            double state = carriedState[(size_t) ch];
+
+            for (int chunk = 0; chunk < numChunks; ++chunk)
+            {
+                const int job = ch * numChunks + chunk;
+                chunkStart[(size_t) job] = state;
+                state = chunkEnd[(size_t) job] + std::pow ((double) b1, (double) chunkRange (chunk).getLength()) * state;
+            }
+
+            carriedState[(size_t) ch] = state;
+        }
+
+        // 3) add the decaying contribution of the previous chunk's state, then HP if needed
+        const bool corrected = runParallel (numChannels * numChunks, [&] (int job)
+        {
+            const int ch = job / numChunks;
+            const auto range = chunkRange (job % numChunks);
+            float* y = lowPass.getWritePointer (ch);
+
+            double correction = chunkStart[(size_t) job] * (double) b1;
+            for (int n = range.getStart(); n < range.getEnd() && std::abs (correction) > 1.0e-12; ++n)
+            {
+                y[n] += (float) correction;
+                correction *= (double) b1;
+            }
+
+            if (type == Type::HighPass)
+            {
+                // y = x - LP(x)
+                juce::FloatVectorOperations::subtract (y + range.getStart(),
+                                                       input.getReadPointer (ch, range.getStart()),
+                                                       y + range.getStart(),
+                                                       range.getLength());
+            }
+        });
+
+        if (! corrected)
+            return;
+
+        if (! writer->writeFromAudioSampleBuffer (lowPass, 0, numSamples))
+            return;
+
+        setProgress ((double) (pos + numSamples) / (double) totalLength);
+    }
+
+    succeeded = true;
+}
+
+void OfflineFilterRenderer::threadComplete (bool userPressedCancel)
+{
+    if (userPressedCancel || ! succeeded)
+    {
+        outputFile.deleteFile();
+
+        if (! userPressedCancel)
+            juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon,
+                                                    "Render failed",
+                                                    "Could not render " + inputFile.getFileName());
+        return;
+    }
+
+    juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::InfoIcon,
+                                            "Render finished",
+                                            "Wrote " + outputFile.getFullPathName());
+}
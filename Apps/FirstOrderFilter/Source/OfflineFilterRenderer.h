@@ -0,0 +1,49 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Renders a whole file through the first-order LP/HP filter, faster than realtime.
+//
+// The one-pole recursion y[n] = a0 * x[n] + b1 * y[n-1] is serial, but it is linear:
+// filtering a chunk from a zero state and then adding b1^(i+1) * y_prev (the true last
+// output of the previous chunk) gives exactly the serial result. So each segment of the
+// file is split into one chunk per core:
+//   1) every chunk is filtered in parallel from a zero state,
+//   2) the chunk end states are carried forward serially (one multiply-add per chunk),
+//   3) every chunk adds its decaying correction term in parallel.
+// High-pass is the complement, x - LP(x), exactly as in the realtime path.
+class OfflineFilterRenderer : public juce::ThreadWithProgressWindow
+{
+public:
+    enum class Type { LowPass, HighPass };
+
+    OfflineFilterRenderer (juce::AudioFormatManager& formatManager,
+                           const juce::File& inputFile, const juce::File& outputFile,
+                           Type type, float cutoffHz);
+    ~OfflineFilterRenderer() override;
+
+    // Same coefficients the realtime filter uses: a0 = 1 - alpha, b1 = alpha
+    static void computeCoefficients (float cutoffHz, double sampleRate, float& a0, float& b1);
+
+private:
+    static constexpr int segmentSize  = 1 << 20; // frames read / written per step
+    static constexpr int minChunkSize = 4096;    // below this, splitting isn't worth it
+
+    juce::AudioFormatManager& formatManager;
+    juce::File inputFile, outputFile;
+    Type type;
+    float cutoffHz;
+    bool succeeded = false;
+
+    juce::ThreadPool pool { juce::jmax (1, juce::SystemStats::getNumCpus()) };
+
+    void run() override;
+    void threadComplete (bool userPressedCancel) override;
+
+    // Runs job (index) for index in [0, numJobs) on the pool and waits for all of them.
+    // Returns false, with none of them left on the pool, if the thread was asked to stop.
+    bool runParallel (int numJobs, const std::function<void (int)>& job);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineFilterRenderer)
+};
@@ -0,0 +1,548 @@
+#include "PlaylistAudioSource.h"
+
+PlaylistAudioSource::PlaylistAudioSource (juce::AudioFormatManager& formatManagerToUse)
+    : juce::Thread ("Playlist pre-roll"),
+      formatManager (formatManagerToUse)
+{
+    readAheadThread.startThread();
+    startThread();
+}
+
+PlaylistAudioSource::~PlaylistAudioSource()
+{
+    stopThread (2000);
+
+    // entries use the read-ahead thread, so they must go before it stops
+    for (auto& slot : slots)
+        slot.reset();
+
+    readAheadThread.stopThread (2000);
+}
+
+//==============================================================================
+// Queue management
+
+void PlaylistAudioSource::clearQueue()
+{
+    {
+        const juce::ScopedLock sl (queueLock);
+        queue.clear();
+        queueSize.store (0);
+    }
+
+    std::unique_ptr<Entry> removed[numSlots];
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        for (int i = 0; i < numSlots; ++i)
+            removed[i] = std::move (slots[i]);
+
+        currentSlot = -1;
+        nextSlot = -1;
+        ++generation;
+        hasItem.store (false);
+    }
+    // removed entries are destroyed here, outside the lock
+}
+
+void PlaylistAudioSource::addToQueue (const juce::URL& url)
+{
+    {
+        const juce::ScopedLock sl (queueLock);
+        queue.add (url);
+        queueSize.store (queue.size());
+    }
+
+    // a pre-rolled wrap-around item is no longer the right one to play next
+    const juce::SpinLock::ScopedLockType sl (lock);
+    dropStaleNext();
+}
+
+int PlaylistAudioSource::getNumQueuedItems() const
+{
+    return queueSize.load();
+}
+
+bool PlaylistAudioSource::startFromIndex (int queueIndex)
+{
+    juce::URL url;
+    {
+        const juce::ScopedLock sl (queueLock);
+        if (! juce::isPositiveAndBelow (queueIndex, queue.size()))
+            return false;
+
+        url = queue.getReference (queueIndex);
+    }
+
+    double rate;
+    int block;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        rate = deviceSampleRate;
+        block = blockSize;
+    }
+
+    auto entry = createEntry (url, queueIndex, rate, block);
+    if (entry == nullptr)
+        return false;
+
+    std::unique_ptr<Entry> removed[numSlots];
+
+    for (;;)
+    {
+        {
+            const juce::SpinLock::ScopedLockType sl (lock);
+
+            if (deviceSampleRate == rate && blockSize == block)
+            {
+                for (int i = 0; i < numSlots; ++i)
+                    removed[i] = std::move (slots[i]);
+
+                slots[0] = std::move (entry);
+                currentSlot = 0;
+                nextSlot = -1;
+                ++generation;
+                hasItem.store (true);
+                break;
+            }
+
+            rate = deviceSampleRate;
+            block = blockSize;
+        }
+
+        // the device was restarted while we were opening the file: prepare again, unlocked
+        prepareEntry (*entry, rate, block);
+    }
+    // previous entries are destroyed here, outside the lock
+
+    return true;
+}
+
+bool PlaylistAudioSource::hasQueueFinished() const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    if (currentSlot < 0 || nextSlot >= 0 || looping.load())
+        return false;
+
+    const auto& current = *slots[currentSlot];
+    return current.position >= current.length
+        && current.queueIndex >= queueSize.load() - 1;
+}
+
+void PlaylistAudioSource::setLooping (bool shouldLoop)
+{
+    looping.store (shouldLoop);
+
+    const juce::SpinLock::ScopedLockType sl (lock);
+    dropStaleNext();
+}
+
+void PlaylistAudioSource::setCrossfadeSeconds (double seconds)
+{
+    crossfadeSeconds.store (juce::jmax (0.0, seconds));
+}
+
+//==============================================================================
+// AudioSource
+
+void PlaylistAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    fadeBuffer.setSize (numOutputChannels, juce::jmax (1, samplesPerBlockExpected));
+
+    // Take the current and next entries out, re-prepare them (which refills their
+    // read-ahead from disk) with no lock held, then put them back.
+    std::unique_ptr<Entry> detached[numSlots];
+    int current, next, expectedGeneration;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        deviceSampleRate = sampleRate;
+        blockSize = samplesPerBlockExpected;
+
+        for (int i = 0; i < numSlots; ++i)
+            if (i == currentSlot || i == nextSlot)
+                detached[i] = std::move (slots[i]);
+
+        current = currentSlot;
+        next = nextSlot;
+        currentSlot = nextSlot = -1;
+        expectedGeneration = ++generation; // in-flight pre-rolls were opened for the old rate
+    }
+
+    for (auto& entry : detached)
+        if (entry != nullptr)
+            prepareEntry (*entry, sampleRate, samplesPerBlockExpected);
+
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+
+        // skip if the queue was restarted or the device re-prepared in the meantime
+        if (generation != expectedGeneration)
+            return;
+
+        for (int i = 0; i < numSlots; ++i)
+            if (detached[i] != nullptr)
+                std::swap (slots[i], detached[i]);
+
+        currentSlot = current;
+        nextSlot = next;
+    }
+    // anything left in detached (entries that were not current or next, or a whole
+    // stale set) is destroyed here, outside the lock
+}
+
+void PlaylistAudioSource::releaseResources()
+{
+    // Same hand-off as prepareToPlay: the entries' read-ahead buffers are freed with no
+    // lock held, then the entries are put back so a restarted device carries on from them.
+    std::unique_ptr<Entry> detached[numSlots];
+    int current, next, expectedGeneration;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+
+        for (int i = 0; i < numSlots; ++i)
+            if (i == currentSlot || i == nextSlot)
+                detached[i] = std::move (slots[i]);
+
+        current = currentSlot;
+        next = nextSlot;
+        currentSlot = nextSlot = -1;
+        expectedGeneration = ++generation;
+    }
+
+    for (auto& entry : detached)
+        if (entry != nullptr)
+            entry->output->releaseResources();
+
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+
+        if (generation != expectedGeneration)
+            return;
+
+        for (int i = 0; i < numSlots; ++i)
+            if (detached[i] != nullptr)
+                std::swap (slots[i], detached[i]);
+
+        currentSlot = current;
+        nextSlot = next;
+    }
+}
+
+void PlaylistAudioSource::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    auto& buffer = *bufferToFill.buffer;
+    const int numSamples = bufferToFill.numSamples;
+    const int startSample = bufferToFill.startSample;
+
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    const auto fadeSamples = getCrossfadeLength();
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        if (currentSlot < 0)
+        {
+            buffer.clear (startSample + done, numSamples - done);
+            return;
+        }
+
+        auto& current = *slots[currentSlot];
+        auto* next = nextSlot >= 0 ? slots[nextSlot].get() : nullptr;
+        const auto remaining = current.length - current.position;
+
+        if (remaining <= 0)
+        {
+            if (next != nullptr)
+            {
+                // Sample-accurate switch: the next item continues in the same block.
+                // The old slot is freed later by the pre-roll thread.
+                currentSlot = nextSlot;
+                nextSlot = -1;
+                continue;
+            }
+
+            // Nothing pre-rolled (end of queue, or loading fell behind): keep counting so
+            // the transport sees the end of the stream unless we are looping.
+            buffer.clear (startSample + done, numSamples - done);
+            current.position += numSamples - done;
+            return;
+        }
+
+        const auto fadeLength = next != nullptr ? juce::jmin (fadeSamples, current.length, next->length)
+                                                : (juce::int64) 0;
+        const auto fadeStart = current.length - fadeLength;
+
+        if (current.position < fadeStart)
+        {
+            const int n = (int) juce::jmin ((juce::int64) (numSamples - done), fadeStart - current.position);
+            readEntry (current, buffer, startSample + done, n);
+            done += n;
+            continue;
+        }
+
+        // Equal-power crossfade: outgoing item in the output buffer, incoming one in fadeBuffer.
+        // The fade is measured from where the incoming item started, which is fadeStart unless
+        // it was pre-rolled late: then it starts at 0 from the block it arrived in and the fade
+        // is shortened to what is left of the outgoing item, instead of joining part-way up.
+        const int n = (int) juce::jmin ((juce::int64) (numSamples - done), remaining,
+                                        (juce::int64) fadeBuffer.getNumSamples());
+        const auto fadePos = next->position;
+        const auto actualFadeLength = fadePos + remaining;
+
+        readEntry (current, buffer, startSample + done, n);
+        readEntry (*next, fadeBuffer, 0, n);
+
+        const int numChans = juce::jmin (buffer.getNumChannels(), fadeBuffer.getNumChannels());
+        const double halfPi = juce::MathConstants<double>::halfPi;
+
+        for (int i = 0; i < n; ++i)
+        {
+            const double t = ((double) (fadePos + i) + 0.5) / (double) actualFadeLength;
+            const auto gainOut = (float) std::cos (t * halfPi);
+            const auto gainIn  = (float) std::sin (t * halfPi);
+
+            for (int ch = 0; ch < numChans; ++ch)
+            {
+                auto* out = buffer.getWritePointer (ch, startSample + done);
+                out[i] = out[i] * gainOut + fadeBuffer.getSample (ch, i) * gainIn;
+            }
+        }
+
+        done += n;
+    }
+}
+
+//==============================================================================
+// PositionableAudioSource
+
+void PlaylistAudioSource::setNextReadPosition (juce::int64 newPosition)
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    if (currentSlot < 0)
+        return;
+
+    auto& current = *slots[currentSlot];
+    seekEntry (current, newPosition);
+
+    // keep the incoming item aligned with the crossfade region (or at its start)
+    if (nextSlot >= 0)
+    {
+        auto& next = *slots[nextSlot];
+        const auto fadeLength = juce::jmin (getCrossfadeLength(), current.length, next.length);
+        seekEntry (next, juce::jmax ((juce::int64) 0, current.position - (current.length - fadeLength)));
+    }
+}
+
+juce::int64 PlaylistAudioSource::getNextReadPosition() const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    return currentSlot >= 0 ? slots[currentSlot]->position : 0;
+}
+
+juce::int64 PlaylistAudioSource::getTotalLength() const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    return currentSlot >= 0 ? slots[currentSlot]->length : 0;
+}
+
+juce::int64 PlaylistAudioSource::getCrossfadeLength() const
+{
+    return (juce::int64) std::round (crossfadeSeconds.load() * deviceSampleRate);
+}
+
+//==============================================================================
+// Entries
+
+std::unique_ptr<PlaylistAudioSource::Entry> PlaylistAudioSource::createEntry (const juce::URL& url, int queueIndex,
+                                                                              double sampleRate, int samplesPerBlock)
+{
+    auto inputStream = url.createInputStream (juce::URL::InputStreamOptions (juce::URL::ParameterHandling::inAddress));
+    if (inputStream == nullptr)
+        return nullptr;
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (std::move (inputStream)));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    auto entry = std::make_unique<Entry>();
+    entry->url = url;
+    entry->queueIndex = queueIndex;
+    entry->fileSampleRate = reader->sampleRate;
+    entry->fileLength = reader->lengthInSamples;
+
+    // Compressed files get a background seek index, so seeking stays constant time
+    const auto localFile = url.isLocalFile() ? url.getLocalFile() : juce::File();
+    entry->buffered = std::make_unique<juce::BufferingAudioSource> (new SeekIndexedAudioSource (reader.release(), localFile),
+                                                                    readAheadThread,
+                                                                    true, readAheadSamples, 2);
+    entry->output = entry->buffered.get();
+
+    // Prefills the read-ahead buffer, so by the time this entry is installed as "next"
+    // its first block is already decoded.
+    if (sampleRate > 0.0)
+        prepareEntry (*entry, sampleRate, samplesPerBlock);
+
+    return entry;
+}
+
+void PlaylistAudioSource::prepareEntry (Entry& entry, double sampleRate, int samplesPerBlock)
+{
+    const double ratio = entry.fileSampleRate / sampleRate;
+    entry.length = (juce::int64) std::round ((double) entry.fileLength / ratio);
+
+    if (std::abs (ratio - 1.0) > 1.0e-9)
+    {
+        if (entry.resampler == nullptr)
+            entry.resampler = std::make_unique<juce::ResamplingAudioSource> (entry.buffered.get(), false, 2);
+
+        entry.resampler->setResamplingRatio (ratio);
+        entry.output = entry.resampler.get();
+    }
+    else
+    {
+        entry.resampler.reset();
+        entry.output = entry.buffered.get();
+    }
+
+    // ResamplingAudioSource prepares its input with the scaled block size and rate
+    entry.output->prepareToPlay (samplesPerBlock, sampleRate);
+    seekEntry (entry, entry.position);
+}
+
+void PlaylistAudioSource::seekEntry (Entry& entry, juce::int64 newPosition)
+{
+    entry.position = juce::jlimit ((juce::int64) 0, entry.length, newPosition);
+
+    const double ratio = entry.length > 0 ? (double) entry.fileLength / (double) entry.length : 1.0;
+    entry.buffered->setNextReadPosition ((juce::int64) std::round ((double) entry.position * ratio));
+
+    if (entry.resampler != nullptr)
+        entry.resampler->flushBuffers();
+}
+
+void PlaylistAudioSource::readEntry (Entry& entry, juce::AudioBuffer<float>& dest, int startSample, int numSamples)
+{
+    entry.output->getNextAudioBlock (juce::AudioSourceChannelInfo (&dest, startSample, numSamples));
+    entry.position += numSamples;
+}
+
+//==============================================================================
+// Pre-roll thread
+
+int PlaylistAudioSource::getExpectedNextIndex (const Entry& current) const
+{
+    const int size = queueSize.load();
+    const int nextIndex = current.queueIndex + 1;
+
+    if (nextIndex < size)
+        return nextIndex;
+
+    return (looping.load() && size > 0) ? 0 : -1;
+}
+
+void PlaylistAudioSource::dropStaleNext()
+{
+    // called with lock held
+    if (currentSlot < 0 || nextSlot < 0)
+        return;
+
+    if (slots[nextSlot]->queueIndex != getExpectedNextIndex (*slots[currentSlot]))
+        nextSlot = -1; // slot is freed by the pre-roll thread
+}
+
+void PlaylistAudioSource::run()
+{
+    while (! threadShouldExit())
+    {
+        releaseUnusedSlots();
+        preRollNextItem();
+
+        // polling keeps the audio thread free of any signalling calls
+        wait (20);
+    }
+}
+
+void PlaylistAudioSource::releaseUnusedSlots()
+{
+    std::unique_ptr<Entry> removed[numSlots];
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+        for (int i = 0; i < numSlots; ++i)
+            if (i != currentSlot && i != nextSlot)
+                removed[i] = std::move (slots[i]);
+    }
+}
+
+void PlaylistAudioSource::preRollNextItem()
+{
+    int nextIndex, expectedGeneration, expectedCurrent, block;
+    double rate;
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+
+        if (deviceSampleRate <= 0.0 || currentSlot < 0 || nextSlot >= 0)
+            return;
+
+        nextIndex = getExpectedNextIndex (*slots[currentSlot]);
+        expectedGeneration = generation;
+        expectedCurrent = currentSlot;
+        rate = deviceSampleRate;
+        block = blockSize;
+    }
+
+    if (nextIndex < 0)
+        return;
+
+    juce::URL url;
+    {
+        const juce::ScopedLock sl (queueLock);
+        if (! juce::isPositiveAndBelow (nextIndex, queue.size()))
+            return;
+
+        url = queue.getReference (nextIndex);
+    }
+
+    // File I/O and prefill happen here, with no lock held
+    auto entry = createEntry (url, nextIndex, rate, block);
+
+    if (entry == nullptr)
+    {
+        // Unreadable item: drop it from the queue so playback doesn't stall on it
+        const juce::ScopedLock ql (queueLock);
+        if (! juce::isPositiveAndBelow (nextIndex, queue.size()) || ! (queue.getReference (nextIndex) == url))
+            return;
+
+        queue.remove (nextIndex);
+
+        const juce::SpinLock::ScopedLockType sl (lock);
+        queueSize.store (queue.size());
+
+        for (auto& slot : slots)
+            if (slot != nullptr && slot->queueIndex > nextIndex)
+                --slot->queueIndex;
+
+        return;
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType sl (lock);
+
+        if (generation != expectedGeneration || currentSlot != expectedCurrent || nextSlot >= 0
+             || deviceSampleRate != rate || blockSize != block
+             || getExpectedNextIndex (*slots[currentSlot]) != nextIndex)
+            return; // state moved on while loading
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            if (slots[i] == nullptr)
+            {
+                slots[i] = std::move (entry);
+                nextSlot = i;
+                break;
+            }
+        }
+    }
+    // an entry that couldn't be installed is destroyed here, outside the lock
+}
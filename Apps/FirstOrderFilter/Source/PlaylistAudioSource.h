@@ -0,0 +1,111 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../../Utils/Audio/SeekIndexedAudioSource.h"
+
+// Gapless playlist: plays a queue of files back to back with sample-accurate switching.
+// The next item is opened, decoded and pre-buffered on background threads while the
+// current one is still playing, so the audio thread only swaps pointers at the boundary.
+// Positions reported through PositionableAudioSource are in output (device) samples of
+// the current item.
+class PlaylistAudioSource : public juce::PositionableAudioSource,
+                            private juce::Thread
+{
+public:
+    explicit PlaylistAudioSource (juce::AudioFormatManager& formatManagerToUse);
+    ~PlaylistAudioSource() override;
+
+    // queue management (message thread)
+    void clearQueue();
+    void addToQueue (const juce::URL& url);
+    int  getNumQueuedItems() const;
+
+    // Opens the given queue item synchronously and makes it the current one.
+    bool startFromIndex (int queueIndex);
+
+    bool hasCurrentItem() const noexcept    { return hasItem.load(); }
+    bool hasQueueFinished() const;
+
+    // Loop mode wraps from the last item back to the first (or repeats a single item).
+    // The wrap target is pre-rolled like any other item, so there is no seek stall.
+    void setLooping (bool shouldLoop) override;
+    bool isLooping() const override         { return looping.load(); }
+
+    // Equal-power crossfade between consecutive items; 0 = hard, gapless cut.
+    void setCrossfadeSeconds (double seconds);
+
+    // Channels of the buffers getNextAudioBlock will be given; takes effect at the next
+    // prepareToPlay, which sizes the crossfade buffer with it.
+    void setNumOutputChannels (int numChannels)     { numOutputChannels = juce::jmax (1, numChannels); }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition (juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+
+private:
+    //==============================================================================
+    // One opened queue item: reader -> read-ahead buffer -> (optional) resampler
+    struct Entry
+    {
+        juce::URL url;
+        int queueIndex = -1;
+
+        std::unique_ptr<juce::BufferingAudioSource> buffered;
+        std::unique_ptr<juce::ResamplingAudioSource> resampler; // only when file rate != device rate
+        juce::AudioSource* output = nullptr;
+
+        double fileSampleRate = 0.0;
+        juce::int64 fileLength = 0;   // in file samples
+        juce::int64 length = 0;       // in output samples
+        juce::int64 position = 0;     // in output samples
+    };
+
+    static constexpr int numSlots = 3;        // current, next and one waiting to be freed
+    static constexpr int readAheadSamples = 65536;
+
+    juce::AudioFormatManager& formatManager;
+    juce::TimeSliceThread readAheadThread { "Playlist read-ahead" };
+
+    // Entry slots and indices; the audio thread holds this for one block,
+    // everyone else only for pointer swaps (never during file I/O).
+    mutable juce::SpinLock lock;
+    std::unique_ptr<Entry> slots[numSlots];
+    int currentSlot = -1;
+    int nextSlot    = -1;
+    int generation  = 0;  // bumped when the queue is restarted, invalidates in-flight loads
+
+    mutable juce::CriticalSection queueLock; // never taken on the audio thread
+    juce::Array<juce::URL> queue;
+    std::atomic<int> queueSize { 0 };
+
+    std::atomic<bool> looping { false };
+    std::atomic<bool> hasItem { false };
+    std::atomic<double> crossfadeSeconds { 0.0 };
+
+    double deviceSampleRate = 0.0;
+    int blockSize = 512;
+    int numOutputChannels = 2;
+
+    juce::AudioBuffer<float> fadeBuffer; // incoming item during a crossfade
+
+    //==============================================================================
+    void run() override;
+
+    std::unique_ptr<Entry> createEntry (const juce::URL& url, int queueIndex, double sampleRate, int samplesPerBlock);
+    static void prepareEntry (Entry& entry, double sampleRate, int samplesPerBlock);
+    static void seekEntry (Entry& entry, juce::int64 newPosition);
+    static void readEntry (Entry& entry, juce::AudioBuffer<float>& dest, int startSample, int numSamples);
+
+    juce::int64 getCrossfadeLength() const;
+    int  getExpectedNextIndex (const Entry& current) const;
+    void dropStaleNext();
+    void preRollNextItem();
+    void releaseUnusedSlots();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaylistAudioSource)
+};
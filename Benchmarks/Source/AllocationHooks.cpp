@@ -0,0 +1,44 @@
+#include <JuceHeader.h>
+
+#include "../../Utils/Audio/MidiThroughputBenchmark.h"
+
+//==============================================================================
+// Allocator hook for MidiThroughputBenchmark. It only exists in this executable: replacing
+// the allocator from inside a plugin would change it for the whole host process.
+//
+// Linux (glibc): malloc, calloc and realloc defined in the executable take precedence over
+// libc's for every shared object in the process, the plugins it loads included, and they
+// forward to glibc's own entry points. Elsewhere there is no hook yet and the benchmark
+// reports the allocation count as "n/a".
+#if JUCE_LINUX
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+
+    void* malloc (size_t size) noexcept
+    {
+        MidiThroughputBenchmark::AllocationCounter::allocationMade();
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t numElements, size_t elementSize) noexcept
+    {
+        MidiThroughputBenchmark::AllocationCounter::allocationMade();
+        return __libc_calloc (numElements, elementSize);
+    }
+
+    void* realloc (void* ptr, size_t size) noexcept
+    {
+        MidiThroughputBenchmark::AllocationCounter::allocationMade();
+        return __libc_realloc (ptr, size);
+    }
+}
+
+static const bool allocationHookInstalled = []
+{
+    MidiThroughputBenchmark::AllocationCounter::isAvailable().store (true);
+    return true;
+}();
+#endif
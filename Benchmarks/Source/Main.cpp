@@ -0,0 +1,110 @@
+#include <JuceHeader.h>
+
+#include "../../Utils/DSP/DelayLineBenchmark.h"
+#include "../../Utils/DSP/MeterKernelBenchmark.h"
+#include "../../Utils/Audio/MidiThroughputBenchmark.h"
+#include "../../Plugins/ArpeggiatorPlugin/Source/ArpStepClock.h"
+#include "../../Apps/AudioFilePlayer/MultitrackMixerBenchmark.h"
+
+//==============================================================================
+// Benchmarks: every benchmark in the repo, in one console app, so nothing is measured
+// while an app or a host is starting up.
+//
+// Projucer: a Console Application with the files in this folder and
+// Apps/AudioFilePlayer/MultitrackMixer.cpp, the juce_audio_basics, juce_audio_formats,
+// juce_audio_processors, juce_core, juce_dsp and juce_events modules, and
+// JUCE_PLUGINHOST_VST3 (and JUCE_PLUGINHOST_AU on macOS) enabled. Build and run the
+// Release configuration; Debug timings say nothing about the shipped code.
+//
+// Usage: Benchmarks [delay] [meter] [arpclock] [mixer] [midi <plugin file>...]
+// With no arguments everything but midi runs; midi takes the plugins to load, e.g. the
+// Release VST3s of ArpeggiatorPlugin and SynthPlugin. The exit code is 1 if a correctness
+// check failed or a plugin allocated in processBlock.
+
+// Prints to the console in every build (DBG is compiled out of Release)
+struct ConsoleLogger : public juce::Logger
+{
+    void logMessage (const juce::String& message) override
+    {
+        std::cout << message << std::endl;
+    }
+};
+
+// MIDI throughput of one plugin file, hosted the way a DAW would load it
+static bool runMidiThroughput (juce::AudioPluginFormatManager& formats, const juce::String& path)
+{
+    juce::OwnedArray<juce::PluginDescription> types;
+
+    for (auto* format : formats.getFormats())
+        if (format->fileMightContainThisPluginType (path))
+            format->findAllTypesForFile (types, path);
+
+    if (types.isEmpty())
+    {
+        juce::Logger::writeToLog ("No plugin found in " + path);
+        return false;
+    }
+
+    juce::String error;
+    auto instance = formats.createPluginInstance (*types.getFirst(), 48000.0, 512, error);
+
+    if (instance == nullptr)
+    {
+        juce::Logger::writeToLog ("Couldn't load " + path + ": " + error);
+        return false;
+    }
+
+    return MidiThroughputBenchmark::logAll (*instance, types.getFirst()->name);
+}
+
+int main (int argc, char* argv[])
+{
+    // Plugins expect a message thread: this one
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    ConsoleLogger logger;
+    juce::Logger::setCurrentLogger (&logger);
+
+    juce::StringArray args, pluginFiles;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        // everything after "midi" is a plugin file
+        if (args.contains ("midi"))
+            pluginFiles.add (argv[i]);
+        else
+            args.add (argv[i]);
+    }
+
+    auto shouldRun = [&args] (const char* name) { return args.isEmpty() || args.contains (name); };
+
+   #if JUCE_DEBUG
+    juce::Logger::writeToLog ("Debug build: the timings below are not representative");
+   #endif
+
+    bool passed = true;
+
+    if (shouldRun ("delay"))
+        passed = DelayLineBenchmark::logAll() && passed;
+
+    if (shouldRun ("meter"))
+        passed = MeterKernelBenchmark::logAll() && passed;
+
+    if (shouldRun ("arpclock"))
+        passed = ArpStepClock::logBenchmark() && passed;
+
+    if (shouldRun ("mixer"))
+        MultitrackMixerBenchmark::logAll();
+
+    if (args.contains ("midi"))
+    {
+        juce::AudioPluginFormatManager formats;
+        formats.addDefaultFormats();
+
+        for (auto& path : pluginFiles)
+            passed = runMidiThroughput (formats, path) && passed;
+    }
+
+    juce::Logger::setCurrentLogger (nullptr);
+    return passed ? 0 : 1;
+}
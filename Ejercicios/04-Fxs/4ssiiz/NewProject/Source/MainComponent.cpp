@@ -76,7 +76,7 @@ MainComponent::MainComponent()
     delayTimeSlider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
     delayTimeSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 80, 20);
     delayTimeSlider.setRange (1.0, 2000.0, 1.0);  // ms
-    delayTimeSlider.setValue (delayTimeMs);
+    delayTimeSlider.setValue (delayParams.getLastWritten().delayTimeMs);
     delayTimeSlider.addListener (this);
     addAndMakeVisible (delayTimeSlider);
 
@@ -87,7 +87,7 @@ MainComponent::MainComponent()
     feedbackSlider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
     feedbackSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 80, 20);
     feedbackSlider.setRange (0.0, 0.95, 0.001);
-    feedbackSlider.setValue (feedback);
+    feedbackSlider.setValue (delayParams.getLastWritten().feedback);
     feedbackSlider.addListener (this);
     addAndMakeVisible (feedbackSlider);
 
@@ -98,7 +98,7 @@ MainComponent::MainComponent()
     wetDrySlider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
     wetDrySlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 80, 20);
     wetDrySlider.setRange (0.0, 1.0, 0.001);
-    wetDrySlider.setValue (wetDryMix);
+    wetDrySlider.setValue (delayParams.getLastWritten().wetDryMix);
     wetDrySlider.addListener (this);
     addAndMakeVisible (wetDrySlider);
 
@@ -154,92 +154,68 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     // MÓDULO: Preparación del Delay Estéreo
     // ============================================================================
     prepareDelayState();
-    
-    // Asegurar que delaySamples coincide con delayTimeMs actual
-    const int newDelaySamples = (int) std::round ((delayTimeMs * 0.001) * currentSampleRate);
-    if (maxDelaySamples > 0)
-        delaySamples = juce::jlimit (1, juce::jmax (1, maxDelaySamples - 1), newDelaySamples);
-    else
-        delaySamples = juce::jmax (1, newDelaySamples);
 }
 
 void MainComponent::prepareDelayState()
 {
     // Máximo delay de 2 segundos
     const float maxDelaySeconds = 2.0f;
-    maxDelaySamples = (int) std::ceil (maxDelaySeconds * currentSampleRate);
+    const int maxDelaySamples = (int) std::ceil (maxDelaySeconds * currentSampleRate);
+
+    // Buffer de delay para ambos canales
+    delayLine.prepare (maxDelaySamples, 2);
+
+    // Rampa de 50 ms al cambiar un parámetro; arranca directamente en los valores actuales
+    const auto& params = delayParams.read();
 
-    // Inicializar buffers de delay para ambos canales
-    delayBufferL.assign ((size_t) maxDelaySamples, 0.0f);
-    delayBufferR.assign ((size_t) maxDelaySamples, 0.0f);
-    writePosL = 0;
-    writePosR = 0;
+    delayLine.setSmoothingTime (currentSampleRate, 0.05);
+    delayLine.setDelay ((float) (params.delayTimeMs * 0.001 * currentSampleRate), true);
 
-    // Asegurar que delaySamples está en rango válido
-    delaySamples = juce::jlimit (1, juce::jmax (1, maxDelaySamples - 1), delaySamples);
+    feedbackSmoothed.reset (currentSampleRate, 0.05);
+    feedbackSmoothed.setCurrentAndTargetValue (params.feedback);
+    wetDrySmoothed.reset (currentSampleRate, 0.05);
+    wetDrySmoothed.setCurrentAndTargetValue (params.wetDryMix);
 }
 
 void MainComponent::processDelayStereo (juce::AudioBuffer<float>& buffer)
 {
-    if (buffer.getNumSamples() <= 0 || delayBufferL.empty() || delayBufferR.empty())
+    if (buffer.getNumSamples() <= 0 || ! delayLine.isPrepared())
         return;
 
-    const int numChannels = buffer.getNumChannels();
+    const int numChannels = juce::jmin (2, buffer.getNumChannels());
     const int numSamples = buffer.getNumSamples();
-    const int delayBuffSize = (int) delayBufferL.size();
 
-    // Procesar canal izquierdo (canal 0)
-    if (numChannels > 0)
-    {
-        auto* dataL = buffer.getWritePointer (0);
-        
-        for (int i = 0; i < numSamples; ++i)
-        {
-            int readPosL = writePosL - delaySamples;
-            if (readPosL < 0)
-                readPosL += delayBuffSize;
+    // Parámetros una vez por bloque; los objetivos se alcanzan muestra a muestra
+    const auto& params = delayParams.read();
+    delayLine.setDelay ((float) (params.delayTimeMs * 0.001 * currentSampleRate));
+    feedbackSmoothed.setTargetValue (params.feedback);
+    wetDrySmoothed.setTargetValue (params.wetDryMix);
 
-            const float delayedL = delayBufferL[(size_t) readPosL];
-            const float inL = dataL[i];
-
-            // Escribir en buffer de delay: entrada + feedback del delay
-            delayBufferL[(size_t) writePosL] = inL + feedback * delayedL;
-
-            // Mezcla dry/wet
-            const float dry = inL * (1.0f - wetDryMix);
-            const float wet = delayedL * wetDryMix;
-            dataL[i] = dry + wet;
-
-            // Avanzar posición circular
-            writePosL = (writePosL + 1) % delayBuffSize;
-        }
-    }
-
-    // Procesar canal derecho (canal 1)
-    if (numChannels > 1)
+    for (int i = 0; i < numSamples; ++i)
     {
-        auto* dataR = buffer.getWritePointer (1);
-        
-        for (int i = 0; i < numSamples; ++i)
+        const float delaySamples = delayLine.getNextDelay();
+        const float feedback = feedbackSmoothed.getNextValue();
+        const float wetDryMix = wetDrySmoothed.getNextValue();
+
+        // Procesar canal izquierdo (canal 0) y derecho (canal 1)
+        for (int ch = 0; ch < numChannels; ++ch)
         {
-            int readPosR = writePosR - delaySamples;
-            if (readPosR < 0)
-                readPosR += delayBuffSize;
+            auto* data = buffer.getWritePointer (ch);
 
-            const float delayedR = delayBufferR[(size_t) readPosR];
-            const float inR = dataR[i];
+            const float delayed = delayLine.read (ch, delaySamples);
+            const float in = data[i];
 
             // Escribir en buffer de delay: entrada + feedback del delay
-            delayBufferR[(size_t) writePosR] = inR + feedback * delayedR;
+            delayLine.write (ch, in + feedback * delayed);
 
             // Mezcla dry/wet
-            const float dry = inR * (1.0f - wetDryMix);
-            const float wet = delayedR * wetDryMix;
-            dataR[i] = dry + wet;
-
-            // Avanzar posición circular
-            writePosR = (writePosR + 1) % delayBuffSize;
+            const float dry = in * (1.0f - wetDryMix);
+            const float wet = delayed * wetDryMix;
+            data[i] = dry + wet;
         }
+
+        // Avanzar posición circular
+        delayLine.advance();
     }
 }
 
@@ -317,11 +293,7 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
 void MainComponent::releaseResources()
 {
     // Limpiar buffers de delay
-    delayBufferL.clear();
-    delayBufferR.clear();
-    writePosL = 0;
-    writePosR = 0;
-    maxDelaySamples = 0;
+    delayLine.release();
 }
 
 //==============================================================================
@@ -462,21 +434,16 @@ void MainComponent::sliderValueChanged (juce::Slider* slider)
     }
     else if (slider == &delayTimeSlider)
     {
-        delayTimeMs = (float) delayTimeSlider.getValue();
-        const int newDelaySamples = (int) std::round ((delayTimeMs * 0.001) * currentSampleRate);
-        
-        if (maxDelaySamples > 0)
-            delaySamples = juce::jlimit (1, juce::jmax (1, maxDelaySamples - 1), newDelaySamples);
-        else
-            delaySamples = juce::jmax (1, newDelaySamples);
+        // el audio thread lo pasa a muestras al comienzo de cada bloque
+        delayParams.update ([this] (DelayParams& p) { p.delayTimeMs = (float) delayTimeSlider.getValue(); });
     }
     else if (slider == &feedbackSlider)
     {
-        feedback = (float) feedbackSlider.getValue();
+        delayParams.update ([this] (DelayParams& p) { p.feedback = (float) feedbackSlider.getValue(); });
     }
     else if (slider == &wetDrySlider)
     {
-        wetDryMix = (float) wetDrySlider.getValue();
+        delayParams.update ([this] (DelayParams& p) { p.wetDryMix = (float) wetDrySlider.getValue(); });
     }
 }
 
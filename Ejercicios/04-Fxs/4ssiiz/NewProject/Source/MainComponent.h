@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../../../Utils/DSP/DelayLine.h"
+#include "../../../../../Utils/DSP/RealtimeParams.h"
 
 //==============================================================================
 // MÓDULO: Synth + Delay - Generador de Audio con Procesamiento
@@ -85,19 +87,24 @@ private:
     //==============================================================================
     // MÓDULO: DSP - Delay Estéreo (Procesador de Audio)
     //==============================================================================
-    // Buffers de delay independientes para cada canal
-    std::vector<float> delayBufferL;
-    std::vector<float> delayBufferR;
-    int writePosL = 0;
-    int writePosR = 0;
-    int delaySamples = 22050;  // default (0.5s @ 44.1kHz)
-    int maxDelaySamples = 0;
+    // Buffer de delay estéreo (L/R intercalados, wrap por bitmask).
+    // El tiempo de delay se suaviza muestra a muestra: mover el slider no hace clicks.
+    DelayLine<float, DelayLineInterpolation::Linear> delayLine;
     double currentSampleRate = 44100.0;
 
-    // Parámetros de delay
-    float delayTimeMs = 400.0f;
-    float feedback = 0.35f;
-    float wetDryMix = 0.5f;  // 0.0 = solo dry, 1.0 = solo wet
+    // Parámetros de delay: los sliders publican una copia completa y el audio thread
+    // la lee una vez por bloque, sin locks (ver RealtimeParams)
+    struct DelayParams
+    {
+        float delayTimeMs = 400.0f;
+        float feedback = 0.35f;
+        float wetDryMix = 0.5f;  // 0.0 = solo dry, 1.0 = solo wet
+    };
+    RealtimeParams<DelayParams> delayParams;
+
+    // Suavizado muestra a muestra (el tiempo de delay lo suaviza el DelayLine)
+    juce::SmoothedValue<float> feedbackSmoothed { 0.35f };
+    juce::SmoothedValue<float> wetDrySmoothed { 0.5f };
 
     //==============================================================================
     // MÓDULO: Funciones Helper - Synth
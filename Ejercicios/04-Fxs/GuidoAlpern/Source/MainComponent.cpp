@@ -34,16 +34,20 @@ MainComponent::MainComponent()
     delayTimeSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     delayTimeSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
     delayTimeSlider.setRange(1.0, 2000.0, 1.0); // ms
-    delayTimeSlider.setValue(delayTimeMs);
+    delayTimeSlider.setValue(delayParams.getLastWritten().delayTimeMs);
 
     feedbackSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     feedbackSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
     feedbackSlider.setRange(0.0, 0.95, 0.001);
-    feedbackSlider.setValue(feedback);
+    feedbackSlider.setValue(delayParams.getLastWritten().feedback);
 
     // Skip toggle button
     skipToggle.setButtonText("Skip Mode");
     skipToggle.setToggleState(false, juce::dontSendNotification);
+    skipToggle.onClick = [this]
+        {
+            delayParams.update([this](DelayParams& p) { p.skipEnabled = skipToggle.getToggleState(); });
+        };
     addAndMakeVisible(skipToggle);
 
     // Labels
@@ -61,20 +65,16 @@ MainComponent::MainComponent()
     // Slider callbacks
     delayTimeSlider.onValueChange = [this]
         {
-            delayTimeMs = (float)delayTimeSlider.getValue();
-            // Map ms to samples and clamp to current max
-            const int newDelaySamples = (int)std::round((delayTimeMs * 0.001) * currentSampleRate);
-            DBG("Delay time changed: " << delayTimeMs << " ms -> " << newDelaySamples << " samples");
+            const float delayTimeMs = (float)delayTimeSlider.getValue();
+            DBG("Delay time changed: " << delayTimeMs << " ms");
 
-            if (maxDelaySamples > 0) // maxDelaySeconds is set to 2 seconds.
-                delaySamples = juce::jlimit(1, juce::jmax(1, maxDelaySamples - 1), newDelaySamples);
-            else
-                delaySamples = juce::jmax(1, newDelaySamples);
+            // The audio thread maps ms to samples (and clamps) at the start of each block
+            delayParams.update([delayTimeMs](DelayParams& p) { p.delayTimeMs = delayTimeMs; });
         };
 
     feedbackSlider.onValueChange = [this]
         {
-            feedback = (float)feedbackSlider.getValue();
+            delayParams.update([this](DelayParams& p) { p.feedback = (float)feedbackSlider.getValue(); });
         };
 
     setButtonsEnabledState();
@@ -110,9 +110,6 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 
     // Prepare delay state
     prepareDelayState();
-
-    // Ensure delaySamples matches current delayTimeMs
-    delayTimeSlider.onValueChange();
 }
 
 void MainComponent::prepareDelayState()
@@ -121,16 +118,16 @@ void MainComponent::prepareDelayState()
     const float maxDelaySeconds = 2.0f; // 2 seconds max delay
     maxDelaySamples = (int)std::ceil(maxDelaySeconds * currentSampleRate);
 
-    delayBuffer.assign((size_t)maxDelaySamples, 0.0f);
-    writePos = 0;
+    delayLine.prepare(maxDelaySamples, 1);
 
-    // Clamp delaySamples to valid range
-    delaySamples = juce::jlimit(1, juce::jmax(1, maxDelaySamples - 1), delaySamples);
+    // Start at the current feedback, ramp over 50 ms on changes
+    feedbackSmoothed.reset(currentSampleRate, 0.05);
+    feedbackSmoothed.setCurrentAndTargetValue(delayParams.read().feedback);
 }
 
 void MainComponent::processDelayChannel(juce::AudioBuffer<float>& buffer, int channelNum)
 {
-    if (buffer.getNumSamples() <= 0 || delayBuffer.empty())
+    if (buffer.getNumSamples() <= 0 || !delayLine.isPrepared())
         return;
 
     if (channelNum < 0 || channelNum >= buffer.getNumChannels())
@@ -138,44 +135,65 @@ void MainComponent::processDelayChannel(juce::AudioBuffer<float>& buffer, int ch
 
     auto* data = buffer.getWritePointer(channelNum);
     const int numSamples = buffer.getNumSamples();
-    int skipCounter = 0;
     const int skipRate = 8;
-    const bool skipEnabled = skipToggle.getToggleState();
 
-    // delayBuffSize es constante, definido en funcion del maximo de delay permitido (2s.)
-    const int delayBuffSize = (int)delayBuffer.size();
+    // Parameters once per block
+    const auto& params = delayParams.read();
+    const bool skipEnabled = params.skipEnabled;
+    const int delaySamples = juce::jlimit(1, juce::jmax(1, maxDelaySamples - 1),
+                                          (int)std::round((params.delayTimeMs * 0.001) * currentSampleRate));
+    feedbackSmoothed.setTargetValue(params.feedback);
 
-    for (int i = 0; i < numSamples; ++i)
+    // Skip mode: the wet level ramps 0..1 over every skipRate samples of the block
+    auto skipFactor = [skipRate](int i)
     {
-        int readPos = writePos - delaySamples;
-        if (readPos < 0)
-            readPos += delayBuffSize;
+        return (float)(i & (skipRate - 1)) / (float)(skipRate - 1);
+    };
 
-        const float delayed = delayBuffer[(size_t)readPos];
-        const float in = data[i]; // read data from buffer
+    if (skipEnabled)
+        DBG("skip factor: " << skipFactor(0) << " (skipRate=" << skipRate << ")");
 
-        delayBuffer[(size_t)writePos] = in + feedback * delayed;
+    if (!feedbackSmoothed.isSmoothing() && delayLine.canProcessSpans(delaySamples, numSamples))
+    {
+        const float feedback = feedbackSmoothed.getTargetValue();
 
-        // Output write to streaming AudioBuffer: dry + wet (fixed 50/50)
-        if (skipEnabled)
+        // Delay >= block: the samples read and the samples written are separate contiguous
+        // runs, so each span is a couple of vector ops instead of a per-sample loop with wrap
+        delayLine.processSpans(delaySamples, numSamples, [&](const float* delayed, float* written, int offset, int n)
         {
-            // Compute factor as float to avoid integer division
-            const float factor = (float)(skipCounter % skipRate) / (float)(skipRate - 1);
+            float* io = data + offset;
+
+            // written = in + feedback * delayed
+            juce::FloatVectorOperations::copy(written, io, n);
+            juce::FloatVectorOperations::addWithMultiply(written, delayed, feedback, n);
+
+            // Output write to streaming AudioBuffer: dry + wet (fixed 50/50)
+            if (skipEnabled)
+            {
+                for (int i = 0; i < n; ++i)
+                    io[i] += skipFactor(offset + i) * delayed[i];  // Aplicar delay
+            }
+            else
+            {
+                juce::FloatVectorOperations::add(io, delayed, n);
+            }
+        });
+        return;
+    }
 
-            // Print the factor for the first sample in this block to avoid flooding the debug output
-            if (i == 0)
-                DBG("skip factor: " << factor << " (skipCounter=" << skipCounter << ", skipRate=" << skipRate << ")");
+    // Very short delays (less than one block) or feedback ramping: per sample
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float feedback = feedbackSmoothed.getNextValue();
+        const float delayed = delayLine.read(0, (float)delaySamples);
+        const float in = data[i]; // read data from buffer
 
-            data[i] = in + factor * delayed;  // Aplicar delay
+        delayLine.write(0, in + feedback * delayed);
 
-            skipCounter++;
-        }
-        else
-        {
-            data[i] = in + delayed;
-        }
+        // Output write to streaming AudioBuffer: dry + wet (fixed 50/50)
+        data[i] = in + (skipEnabled ? skipFactor(i) : 1.0f) * delayed;
 
-        writePos = (writePos + 1) % delayBuffSize;
+        delayLine.advance();
     }
 }
 
@@ -203,8 +221,7 @@ void MainComponent::releaseResources()
     transport.releaseResources();
 
     // Clear delay buffers
-    delayBuffer.clear();
-    writePos = 0;
+    delayLine.release();
     maxDelaySamples = 0;
 }
 
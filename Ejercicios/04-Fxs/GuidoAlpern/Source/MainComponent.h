@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../../Utils/DSP/DelayLine.h"
+#include "../../../../Utils/DSP/RealtimeParams.h"
 
 //==============================================================================
 /*
@@ -54,14 +56,18 @@ private:
 
     //==============================================================================
     // Simple mono delay state (channel 0 only)
-    // Parameters
-    float delayTimeMs   = 400.0f;  // delay time in milliseconds (mapped to delaySamples)
-    float feedback      = 0.35f;   // 0..<1
+    // Parameters: written by the controls, read once per block by the audio thread
+    struct DelayParams
+    {
+        float delayTimeMs   = 400.0f;  // delay time in milliseconds (mapped to samples per block)
+        float feedback      = 0.35f;   // 0..<1
+        bool  skipEnabled   = false;
+    };
+    RealtimeParams<DelayParams> delayParams;
+    juce::SmoothedValue<float> feedbackSmoothed { 0.35f }; // per-sample ramp to the new feedback
 
-    // Delay buffer (single channel)
-    std::vector<float> delayBuffer;
-    int writePos = 0;
-    int delaySamples = 22050;      // default (0.5s @ 44.1kHz); clamped in prepare
+    // Delay buffer (single channel, power-of-two length with bitmask wrap)
+    DelayLine<float, DelayLineInterpolation::None> delayLine;
 
     // Limits and rate
     int maxDelaySamples = 0;
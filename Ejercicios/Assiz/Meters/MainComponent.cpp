@@ -57,13 +57,13 @@ void MainComponent::setupGuiComponents()
     smoothingSlider.setRange (0.0, 1.0, 0.001);
     
     // Invert mapping: slider shows "smoothing amount", alpha is "snappiness".
-    smoothingSlider.setValue (rmsSmoothingAlpha, juce::dontSendNotification);
+    smoothingSlider.setValue (rmsSmoothingAlpha.getLastWritten(), juce::dontSendNotification);
     smoothingSlider.setTextValueSuffix ("");
     smoothingSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 60, 20);
     smoothingSlider.onValueChange = [this]
     {
         const double sliderVal = smoothingSlider.getValue();
-        rmsSmoothingAlpha = (float) (sliderVal);
+        rmsSmoothingAlpha.write ((float) sliderVal);
     };
     addAndMakeVisible (smoothingSlider);
 
@@ -188,16 +188,13 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     if (auto* dev = deviceManager.getCurrentAudioDevice())
         numOutChans = juce::jmax (1, dev->getActiveOutputChannels().countNumberOfSetBits());
 
-    {
-        // Protección thread-safe para acceso concurrente desde el hilo de audio
-        const juce::SpinLock::ScopedLockType sl (rmsLock);
-        lastRms.clearQuick();
-        smoothedRms.clearQuick();
-        peakRms.clearQuick();
-        lastRms.insertMultiple (0, 0.0f, numOutChans);
-        smoothedRms.insertMultiple (0, 0.0f, numOutChans);
-        peakRms.insertMultiple (0, 0.0f, numOutChans);
-    }
+    // Estado del hilo de audio (el audio todavía no corre): hasta MeterValues<>::maxChannels
+    smoothedRms.reset (numOutChans);
+    peakRms.reset (numOutChans);
+
+    // Pico verdadero: se retiene hasta resetPeakRms(), igual que los picos RMS
+    truePeakMeter.setHoldTime (0.0);
+    truePeakMeter.prepare (sampleRate, numOutChans);
 }
 
 //==============================================================================
@@ -215,13 +212,13 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     {
         bufferToFill.clearActiveBufferRegion();
         // También resetea RMS a cero cuando no hay fuente
-        const juce::SpinLock::ScopedLockType sl (rmsLock);
         for (int c = 0; c < smoothedRms.size(); ++c)
         {
             smoothedRms.set (c, 0.0f);
             peakRms.set (c, 0.0f);  // Resetear picos también
         }
-        lastRms = smoothedRms;
+        truePeakMeter.reset();
+        publishedReadings.write ({ smoothedRms, peakRms, truePeakMeter.getHeldPeaks() });
         return;
     }
 
@@ -239,31 +236,16 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     if (buffer == nullptr || bufferToFill.numSamples <= 0)
         return;
 
-    const int numChans = buffer->getNumChannels();
     const int n = bufferToFill.numSamples;
     const int start = bufferToFill.startSample;
     
     // Calcular RMS instantáneo para cada canal
-    juce::Array<float> instantRms;
-    instantRms.insertMultiple (0, 0.0f, numChans);
-
-    for (int ch = 0; ch < numChans; ++ch)
-    {
-        const float* data = buffer->getReadPointer (ch, start);
+    MeterValues<> instantRms; // array fijo: nada de memoria dinámica por bloque
+    MeterKernel::computeRms (*buffer, start, n, instantRms);
 
-        // Suma de cuadrados de las muestras
-        double sumSquares = 0.0;
-        for (int i = 0; i < n; ++i)
-        {
-            const float s = data[i];
-            sumSquares += (double) s * (double) s;
-        }
-        
-        // Promedio y raíz cuadrada
-        auto sumSquaresDiv = sumSquares / (double) n;
-        const float rms = std::sqrt ((float) sumSquaresDiv);
-        instantRms.set (ch, rms);
-    }
+    // Pico verdadero (BS.1770-4): sobremuestreo 4x, detecta los picos entre muestras
+    // que el pico de muestra no ve
+    truePeakMeter.process (*buffer, start, n);
 
     // ============================================================================
     // MÓDULO: Suavizado Exponencial de Valores RMS
@@ -273,20 +255,28 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     // donde alpha es el factor de suavizado (0 = sin suavizado, 1 = máximo suavizado)
     
     {
-        const juce::SpinLock::ScopedLockType sl (rmsLock); // Protección thread-safe
-        const float a = juce::jlimit (0.0f, 1.0f, rmsSmoothingAlpha);
+        // Pedido de resetPeakRms desde la UI
+        if (peakResetRequested.exchange (false))
+        {
+            peakRms.reset (peakRms.size());
+            truePeakMeter.resetHold();
+        }
+
+        const float a = juce::jlimit (0.0f, 1.0f, rmsSmoothingAlpha.read());
         const float b = 1.0f - a;
 
         for (int ch = 0; ch < smoothedRms.size(); ++ch)
         {
             const float sm = b * instantRms[ch] + a * smoothedRms[ch];
             smoothedRms.set (ch, sm);
-            lastRms.set (ch, sm);
             
             // Actualizar pico máximo si el valor actual es mayor
             if (sm > peakRms[ch])
                 peakRms.set (ch, sm);
         }
+
+        // Publicar para la UI: sin lock, el hilo de audio nunca espera
+        publishedReadings.write ({ smoothedRms, peakRms, truePeakMeter.getHeldPeaks() });
     }
 }
 
@@ -504,6 +494,7 @@ void MainComponent::paint (juce::Graphics& g)
         auto peakValues = getPeakRms();
         const float peakValue = (i < peakValues.size()) ? peakValues[i] : 0.0f;
         const float peakDbValue = rmsToDbFs (peakValue);
+        const float truePeakDbValue = TruePeakMeter<>::toDecibels (getTruePeak()[i]);
         
         // Dibujar etiqueta con el valor actual en dBFS
         juce::String labelText = juce::String (dbValue, 1) + " dBFS";
@@ -523,7 +514,9 @@ void MainComponent::paint (juce::Graphics& g)
             // Usar CharPointer_UTF8 para manejar correctamente caracteres no-ASCII (á en "máximo")
             juce::String peakText = juce::String (juce::CharPointer_UTF8 (u8"Pico máximo: ")) 
                                   + juce::String (peakDbValue, 1) 
-                                  + juce::String (" dBFS");
+                                  + juce::String (" dBFS   Pico verdadero: ")
+                                  + juce::String (truePeakDbValue, 1)
+                                  + juce::String (" dBTP");
             auto peakLabelBounds = meterRowBounds;  // Usar el área reservada para el texto
             g.setColour (juce::Colours::lightgrey);
             g.drawFittedText (peakText, peakLabelBounds, juce::Justification::centredLeft, 1);
@@ -651,28 +644,29 @@ void MainComponent::setButtonsEnabledState()
 // MÓDULO: Acceso Thread-Safe a Valores RMS
 //==============================================================================
 
-juce::Array<float> MainComponent::getLatestRms() const
+MeterValues<> MainComponent::getLatestRms() const
+{
+    // Retorna una copia de los últimos valores RMS publicados por el hilo de audio
+    // (sin lock ni memoria dinámica; sólo desde el hilo de UI)
+    return publishedReadings.read().rms;
+}
+
+MeterValues<> MainComponent::getPeakRms() const
 {
-    // Retorna una copia thread-safe de los últimos valores RMS calculados
-    // Este método puede ser llamado desde el hilo de UI de forma segura
-    const juce::SpinLock::ScopedLockType sl (rmsLock);
-    return lastRms; // Retorna una copia
+    // Retorna una copia de los últimos picos máximos RMS publicados por el hilo de audio
+    return publishedReadings.read().peak;
 }
 
-juce::Array<float> MainComponent::getPeakRms() const
+MeterValues<> MainComponent::getTruePeak() const
 {
-    // Retorna una copia thread-safe de los picos máximos RMS alcanzados
-    // Este método puede ser llamado desde el hilo de UI de forma segura
-    const juce::SpinLock::ScopedLockType sl (rmsLock);
-    return peakRms; // Retorna una copia
+    // Retorna una copia del último pico verdadero máximo publicado por el hilo de audio
+    return publishedReadings.read().truePeak;
 }
 
 void MainComponent::resetPeakRms()
 {
-    // Resetea los picos máximos RMS para todos los canales
-    const juce::SpinLock::ScopedLockType sl (rmsLock);
-    for (int ch = 0; ch < peakRms.size(); ++ch)
-        peakRms.set (ch, 0.0f);
+    // Los picos son del hilo de audio: se resetean allá, en el próximo bloque
+    peakResetRequested.store (true);
 }
 
 //==============================================================================
@@ -823,7 +817,7 @@ void MainComponent::disconnectOsc()
     }
 }
 
-void MainComponent::sendRmsOverOsc (const juce::Array<float>& values)
+void MainComponent::sendRmsOverOsc (const MeterValues<>& values)
 {
     // ============================================================================
     // MÓDULO: Envío de Valores RMS vía OSC
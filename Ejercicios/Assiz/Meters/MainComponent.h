@@ -1,6 +1,10 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../Utils/DSP/RealtimeParams.h"
+#include "../../../Utils/DSP/MeterValues.h"
+#include "../../../Utils/DSP/MeterKernel.h"
+#include "../../../Utils/DSP/TruePeakMeter.h"
 
 // PROJUCER needs to add juce_osc
 
@@ -50,14 +54,18 @@ public:
     // MÓDULO: Acceso a Valores RMS
     //==============================================================================
     // Retorna los últimos valores RMS calculados (por canal).
-    // Thread-safe: puede ser llamado desde el hilo de UI de forma segura.
-    juce::Array<float> getLatestRms() const;
+    // Sin locks ni memoria dinámica: se llama desde el hilo de UI.
+    MeterValues<> getLatestRms() const;
     
     // Retorna los picos máximos RMS alcanzados (por canal).
-    // Thread-safe: puede ser llamado desde el hilo de UI de forma segura.
-    juce::Array<float> getPeakRms() const;
+    // Sin locks ni memoria dinámica: se llama desde el hilo de UI.
+    MeterValues<> getPeakRms() const;
     
-    // Resetea los picos máximos RMS para todos los canales.
+    // Retorna el pico verdadero máximo (BS.1770-4, lineal: 1 = 0 dBTP) por canal.
+    // Sin locks ni memoria dinámica: se llama desde el hilo de UI.
+    MeterValues<> getTruePeak() const;
+    
+    // Resetea los picos máximos RMS y de pico verdadero para todos los canales (en el próximo bloque de audio).
     void resetPeakRms();
 
 private:
@@ -135,7 +143,7 @@ private:
     //==============================================================================
     void updateOscConnection();           // Actualiza conexión OSC con parámetros actuales
     void disconnectOsc();                 // Desconecta el sender OSC
-    void sendRmsOverOsc (const juce::Array<float>& values);  // Envía valores RMS vía OSC
+    void sendRmsOverOsc (const MeterValues<>& values);  // Envía valores RMS vía OSC
     void reconnectOscIfEnabled();        // Reconecta OSC si está habilitado
     void handleOscEnableToggleClicked();  // Maneja clic en toggle de OSC
 
@@ -143,14 +151,21 @@ private:
     // MÓDULO: Medición RMS - Almacenamiento Thread-Safe
     //==============================================================================
     // Los valores RMS se calculan en el hilo de audio y se leen desde el hilo de UI.
-    // Se utiliza un SpinLock para proteger el acceso concurrente.
-    mutable juce::SpinLock rmsLock;       // Lock para acceso thread-safe
-    juce::Array<float> lastRms;          // Últimos valores RMS calculados (copia para UI)
-    juce::Array<float> smoothedRms;      // Valores RMS suavizados (usado en cálculo)
-    float rmsSmoothingAlpha = 0.2f;       // Factor de suavizado (0 = sin suavizado, 1 = máximo)
-    
-    // Picos máximos por canal (valores RMS máximos alcanzados)
-    juce::Array<float> peakRms;          // Picos máximos RMS por canal (thread-safe con rmsLock)
+    // El hilo de audio es dueño de smoothedRms y peakRms y publica una copia de los dos
+    // en cada bloque; la UI lee la última sin locks (el audio nunca espera a la UI).
+    struct RmsReadings
+    {
+        MeterValues<> rms;               // RMS suavizado por canal
+        MeterValues<> peak;              // Picos máximos RMS por canal
+        MeterValues<> truePeak;          // Pico verdadero máximo por canal (lineal)
+    };
+
+    MeterValues<> smoothedRms;           // Valores RMS suavizados (sólo hilo de audio)
+    MeterValues<> peakRms;               // Picos máximos RMS por canal (sólo hilo de audio)
+    TruePeakMeter<> truePeakMeter;       // Pico verdadero con sobremuestreo 4x (sólo hilo de audio)
+    mutable RealtimeParams<RmsReadings> publishedReadings; // hilo de audio -> UI
+    std::atomic<bool> peakResetRequested { false };        // UI -> hilo de audio (resetPeakRms)
+    RealtimeParams<float> rmsSmoothingAlpha { 0.2f }; // Factor de suavizado (0 = sin suavizado, 1 = máximo)
     
     //==============================================================================
     // MÓDULO: Configuración de Umbrales de Segmentación de Colores
@@ -37,12 +37,12 @@ void MainComponent::setupGuiComponents()
     addAndMakeVisible(bassSmoothingLabel);
 
     bassSmoothingSlider.setRange(0.0, 1.0, 0.001);
-    bassSmoothingSlider.setValue(bassSmoothingAlpha, juce::dontSendNotification);
+    bassSmoothingSlider.setValue(bandAlphas.getLastWritten().bass, juce::dontSendNotification);
     bassSmoothingSlider.setTextValueSuffix("");
     bassSmoothingSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
     bassSmoothingSlider.onValueChange = [this]
         {
-            bassSmoothingAlpha = (float)bassSmoothingSlider.getValue();
+            bandAlphas.update([this](BandAlphas& a) { a.bass = (float)bassSmoothingSlider.getValue(); });
         };
     addAndMakeVisible(bassSmoothingSlider);
 
@@ -52,12 +52,12 @@ void MainComponent::setupGuiComponents()
     addAndMakeVisible(midSmoothingLabel);
 
     midSmoothingSlider.setRange(0.0, 1.0, 0.001);
-    midSmoothingSlider.setValue(midSmoothingAlpha, juce::dontSendNotification);
+    midSmoothingSlider.setValue(bandAlphas.getLastWritten().mid, juce::dontSendNotification);
     midSmoothingSlider.setTextValueSuffix("");
     midSmoothingSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
     midSmoothingSlider.onValueChange = [this]
         {
-            midSmoothingAlpha = (float)midSmoothingSlider.getValue();
+            bandAlphas.update([this](BandAlphas& a) { a.mid = (float)midSmoothingSlider.getValue(); });
         };
     addAndMakeVisible(midSmoothingSlider);
 
@@ -67,12 +67,12 @@ void MainComponent::setupGuiComponents()
     addAndMakeVisible(trebleSmoothingLabel);
 
     trebleSmoothingSlider.setRange(0.0, 1.0, 0.001);
-    trebleSmoothingSlider.setValue(trebleSmoothingAlpha, juce::dontSendNotification);
+    trebleSmoothingSlider.setValue(bandAlphas.getLastWritten().treble, juce::dontSendNotification);
     trebleSmoothingSlider.setTextValueSuffix("");
     trebleSmoothingSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
     trebleSmoothingSlider.onValueChange = [this]
         {
-            trebleSmoothingAlpha = (float)trebleSmoothingSlider.getValue();
+            bandAlphas.update([this](BandAlphas& a) { a.treble = (float)trebleSmoothingSlider.getValue(); });
         };
     addAndMakeVisible(trebleSmoothingSlider);
 
@@ -122,11 +122,12 @@ void MainComponent::setupGuiComponents()
 void MainComponent::setupAudioPlayer()
 {
     formatManager.registerBasicFormats();
-    setAudioChannels(0, 2);
 
-    // Initialize frequency bands arrays
-    lastFrequencyBands = { 0.0f, 0.0f, 0.0f };
-    smoothedFrequencyBands = { 0.0f, 0.0f, 0.0f };
+    // Initialize frequency bands (before the audio thread starts: it owns them from then on)
+    smoothedFrequencyBands.reset(3);
+    publishedFrequencyBands.write(smoothedFrequencyBands);
+
+    setAudioChannels(0, 2);
 }
 
 void MainComponent::setupFilters()
@@ -169,14 +170,11 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 
     setupFilters();
 
-    // Initialize frequency bands arrays
-    {
-        const juce::SpinLock::ScopedLockType sl(bandsLock);
-        lastFrequencyBands.clearQuick();
-        smoothedFrequencyBands.clearQuick();
-        lastFrequencyBands = { 0.0f, 0.0f, 0.0f };
-        smoothedFrequencyBands = { 0.0f, 0.0f, 0.0f };
-    }
+    // Initialize frequency bands
+    smoothedFrequencyBands.reset(3);
+
+    // True peak, held 2 seconds
+    truePeakMeter.prepare(sampleRate, 2);
 }
 
 void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
@@ -186,10 +184,12 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
     {
         bufferToFill.clearActiveBufferRegion();
         // Also reset frequency bands to zero when no source
-        const juce::SpinLock::ScopedLockType sl(bandsLock);
         for (int i = 0; i < smoothedFrequencyBands.size(); ++i)
             smoothedFrequencyBands.set(i, 0.0f);
-        lastFrequencyBands = smoothedFrequencyBands;
+        publishedFrequencyBands.write(smoothedFrequencyBands);
+
+        truePeakMeter.reset();
+        publishedTruePeak.write(truePeakMeter.getHeldPeaks());
         return;
     }
 
@@ -204,6 +204,10 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
     const int n = bufferToFill.numSamples;
     const int start = bufferToFill.startSample;
 
+    // True peak of the output, before the band filtering
+    truePeakMeter.process(*buffer, start, n);
+    publishedTruePeak.write(truePeakMeter.getHeldPeaks());
+
     // CREAR BUFFER TEMPORALES PARA LAS SEALES FILTRADAS
     juce::AudioBuffer<float> bassBuffer(numChans, n);
     juce::AudioBuffer<float> midBuffer(numChans, n);
@@ -241,75 +245,46 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
         }
     }
 
-    // CALCULAR RMS PARA CADA BANDA DE FRENCUENCIA
-    juce::Array<float> instantBands;
-    instantBands.insertMultiple(0, 0.0f, 3); // [graves, medios, agudos]
-
-    // GRAVES RMS
-    double bassSumSquares = 0.0;
-    for (int ch = 0; ch < numChans; ++ch)
+    // CALCULAR RMS PARA CADA BANDA DE FRENCUENCIA (todos los canales juntos)
+    auto bandRms = [n, numChans](const juce::AudioBuffer<float>& band)
     {
-        const float* data = bassBuffer.getReadPointer(ch);
-        for (int i = 0; i < n; ++i)
-        {
-            const float s = data[i];
-            bassSumSquares += (double)s * (double)s;
-        }
-    }
-    auto bassRms = std::sqrt((float)(bassSumSquares / (double)(n * numChans)));
-    instantBands.set(0, bassRms);
+        double sumSquares = 0.0;
+        for (int ch = 0; ch < numChans; ++ch)
+            sumSquares += MeterKernel::analyseChannel(band.getReadPointer(ch), n).sumOfSquares;
 
-    // MEDIOS RMS
-    double midSumSquares = 0.0;
-    for (int ch = 0; ch < numChans; ++ch)
-    {
-        const float* data = midBuffer.getReadPointer(ch);
-        for (int i = 0; i < n; ++i)
-        {
-            const float s = data[i];
-            midSumSquares += (double)s * (double)s;
-        }
-    }
-    auto midRms = std::sqrt((float)(midSumSquares / (double)(n * numChans)));
-    instantBands.set(1, midRms);
+        return std::sqrt((float)(sumSquares / (double)(n * numChans)));
+    };
 
-    // AGUDOS RMS
-    double trebleSumSquares = 0.0;
-    for (int ch = 0; ch < numChans; ++ch)
-    {
-        const float* data = trebleBuffer.getReadPointer(ch);
-        for (int i = 0; i < n; ++i)
-        {
-            const float s = data[i];
-            trebleSumSquares += (double)s * (double)s;
-        }
-    }
-    auto trebleRms = std::sqrt((float)(trebleSumSquares / (double)(n * numChans)));
-    instantBands.set(2, trebleRms);
+    MeterValues<3> instantBands; // [graves, medios, agudos], array fijo
+    instantBands.reset(3);
+    instantBands.set(0, bandRms(bassBuffer));   // GRAVES RMS
+    instantBands.set(1, bandRms(midBuffer));    // MEDIOS RMS
+    instantBands.set(2, bandRms(trebleBuffer)); // AGUDOS RMS
 
     // SMOOTHING PARA CADA BANDA
     {
-        const juce::SpinLock::ScopedLockType sl(bandsLock);
+        const auto& alphas = bandAlphas.read(); // latest slider values, once per block
 
         // Graves smoothing
-        const float bassA = juce::jlimit(0.0f, 1.0f, bassSmoothingAlpha);
+        const float bassA = juce::jlimit(0.0f, 1.0f, alphas.bass);
         const float bassB = 1.0f - bassA;
         const float bassSm = bassB * instantBands[0] + bassA * smoothedFrequencyBands[0];
         smoothedFrequencyBands.set(0, bassSm);
 
         // Medios smoothing
-        const float midA = juce::jlimit(0.0f, 1.0f, midSmoothingAlpha);
+        const float midA = juce::jlimit(0.0f, 1.0f, alphas.mid);
         const float midB = 1.0f - midA;
         const float midSm = midB * instantBands[1] + midA * smoothedFrequencyBands[1];
         smoothedFrequencyBands.set(1, midSm);
 
         // Agudos smoothing
-        const float trebleA = juce::jlimit(0.0f, 1.0f, trebleSmoothingAlpha);
+        const float trebleA = juce::jlimit(0.0f, 1.0f, alphas.treble);
         const float trebleB = 1.0f - trebleA;
         const float trebleSm = trebleB * instantBands[2] + trebleA * smoothedFrequencyBands[2];
         smoothedFrequencyBands.set(2, trebleSm);
 
-        lastFrequencyBands = smoothedFrequencyBands;
+        // Publish for the UI: no lock, the audio thread never waits
+        publishedFrequencyBands.write(smoothedFrequencyBands);
     }
 }
 
@@ -335,6 +310,17 @@ void MainComponent::paint(juce::Graphics& g)
         juce::Colours::yellow
     };
 
+    // True peak per channel (dBTP) above the bars
+    auto truePeaks = getLatestTruePeak();
+    juce::String truePeakText = "TRUE PEAK";
+    for (int ch = 0; ch < truePeaks.size(); ++ch)
+        truePeakText << "   Ch " << (ch + 1) << ": " << juce::String(TruePeakMeter<2>::toDecibels(truePeaks[ch]), 1) << " dBTP";
+
+    g.setColour(juce::Colours::white);
+    g.setFont(juce::Font(juce::FontOptions(14.0f)));
+    g.drawFittedText(truePeakText, bounds.removeFromTop(20), juce::Justification::centredLeft, 1);
+    bounds.removeFromTop(10);
+
     const int numBands = juce::jmax(1, bandValues.size());
     auto barsArea = bounds;
     const int gap = 20;
@@ -449,10 +435,14 @@ void MainComponent::setButtonsEnabledState()
     }
 }
 
-juce::Array<float> MainComponent::getLatestFrequencyBands() const
+MeterValues<3> MainComponent::getLatestFrequencyBands() const
+{
+    return publishedFrequencyBands.read(); // returns a copy
+}
+
+MeterValues<2> MainComponent::getLatestTruePeak() const
 {
-    const juce::SpinLock::ScopedLockType sl(bandsLock);
-    return lastFrequencyBands; // returns a copy
+    return publishedTruePeak.read(); // returns a copy
 }
 
 void MainComponent::timerCallback()
@@ -551,7 +541,7 @@ void MainComponent::disconnectOsc()
     }
 }
 
-void MainComponent::sendFrequencyBandsOverOsc(const juce::Array<float>& values)
+void MainComponent::sendFrequencyBandsOverOsc(const MeterValues<3>& values)
 {
     if (!oscConnected)
         return;
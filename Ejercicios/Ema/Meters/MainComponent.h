@@ -1,6 +1,10 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../Utils/DSP/RealtimeParams.h"
+#include "../../../Utils/DSP/MeterValues.h"
+#include "../../../Utils/DSP/MeterKernel.h"
+#include "../../../Utils/DSP/TruePeakMeter.h"
 
 // PROJUCER needs to add juce_osc
 
@@ -25,8 +29,11 @@ public:
     void setupGuiComponents();
     void setupAudioPlayer();
 
-    // Access latest frequency band values (bass/mid/treble). Thread-safe snapshot.
-    juce::Array<float> getLatestFrequencyBands() const;
+    // Access latest frequency band values (bass/mid/treble). Lock-free snapshot, UI thread only.
+    MeterValues<3> getLatestFrequencyBands() const;
+
+    // Access latest true peak per channel (BS.1770-4, linear: 1 = 0 dBTP, held 2 s). Lock-free snapshot, UI thread only.
+    MeterValues<2> getLatestTruePeak() const;
 
 private:
     //==============================================================================
@@ -75,24 +82,32 @@ private:
     /// OSC helpers
     void updateOscConnection();
     void disconnectOsc();
-    void sendFrequencyBandsOverOsc(const juce::Array<float>& values);
+    void sendFrequencyBandsOverOsc(const MeterValues<3>& values);
     void reconnectOscIfEnabled();
     void handleOscEnableToggleClicked(); // extracted handler
 
-    // Frequency band analysis
-    mutable juce::SpinLock bandsLock;
-    juce::Array<float> lastFrequencyBands; // [bass, mid, treble]
-    juce::Array<float> smoothedFrequencyBands;
+    // Frequency band analysis: the audio thread owns smoothedFrequencyBands and publishes
+    // a copy every block; the UI reads the latest one without locking or allocating
+    MeterValues<3> smoothedFrequencyBands;                          // [bass, mid, treble], audio thread only
+    mutable RealtimeParams<MeterValues<3>> publishedFrequencyBands; // audio thread -> UI
+
+    // True peak of the stereo output: 4x oversampled, so inter-sample overs show up
+    TruePeakMeter<2> truePeakMeter;                                 // audio thread only
+    mutable RealtimeParams<MeterValues<2>> publishedTruePeak;       // audio thread -> UI
 
     // Filters for frequency bands
     juce::IIRFilter bassFilterL, bassFilterR;
     juce::IIRFilter midFilterL, midFilterR;
     juce::IIRFilter trebleFilterL, trebleFilterR;
 
-    // Smoothing factors for each band
-    float bassSmoothingAlpha = 0.3f;
-    float midSmoothingAlpha = 0.3f;
-    float trebleSmoothingAlpha = 0.3f;
+    // Smoothing factors for each band: written by the sliders, read once per block by the audio thread
+    struct BandAlphas
+    {
+        float bass = 0.3f;
+        float mid = 0.3f;
+        float treble = 0.3f;
+    };
+    RealtimeParams<BandAlphas> bandAlphas;                          // sliders -> audio thread
 
     double currentSampleRate = 44100.0;
 
@@ -39,13 +39,13 @@ void MainComponent::setupGuiComponents()
     smoothingSlider.setRange(0.0, 1.0, 0.001);
 
     // Invert mapping: slider shows "smoothing amount", alpha is "snappiness".
-    smoothingSlider.setValue(rmsSmoothingAlpha, juce::dontSendNotification);
+    smoothingSlider.setValue(rmsSmoothingAlpha.getLastWritten(), juce::dontSendNotification);
     smoothingSlider.setTextValueSuffix("");
     smoothingSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 20);
     smoothingSlider.onValueChange = [this]
         {
             const double sliderVal = smoothingSlider.getValue();
-            rmsSmoothingAlpha = (float)(sliderVal);
+            rmsSmoothingAlpha.write((float)sliderVal);
         };
     addAndMakeVisible(smoothingSlider);
 
@@ -109,18 +109,11 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
     if (auto* dev = deviceManager.getCurrentAudioDevice())
         numOutChans = juce::jmax(1, dev->getActiveOutputChannels().countNumberOfSetBits());
 
-    {
-        const juce::SpinLock::ScopedLockType sl(rmsLock);
-        lastRms.clearQuick();
-        smoothedRms.clearQuick();
-        lastRms.insertMultiple(0, 0.0f, numOutChans);
-        smoothedRms.insertMultiple(0, 0.0f, numOutChans);
-    }
+    features = {};
+    features.rms.reset(numOutChans); // up to MeterValues<>::maxChannels
 
     currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
     envelopeState = 0.0f;
-    lastPeak = 0.0f;
-    lastEnvelope = 0.0f;
 }
 
 void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
@@ -129,16 +122,12 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
     if (readerSource == nullptr)
     {
         bufferToFill.clearActiveBufferRegion();
-        // Also reset RMS to zero when no source
-        const juce::SpinLock::ScopedLockType sl(rmsLock);
-        for (int c = 0; c < smoothedRms.size(); ++c)
-            smoothedRms.set(c, 0.0f);
-        lastRms = smoothedRms;
-
-        const juce::SpinLock::ScopedLockType sl2(audioFeatLock);
-        lastPeak = 0.0f;
-        lastEnvelope = 0.0f;
+        // Also reset RMS and features to zero when no source
+        features.rms.reset(features.rms.size());
+        features.peak = 0.0f;
+        features.envelope = 0.0f;
         envelopeState = 0.0f;
+        publishedFeatures.write(features);
         return;
     }
 
@@ -150,7 +139,7 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
         return;
 
     // 3) Calculate instant RMS
-    juce::Array<float> instantRms;
+    MeterValues<> instantRms; // fixed array: nothing allocated per block
     calculateInstantRms(buffer, bufferToFill.startSample, bufferToFill.numSamples, instantRms);
 
     // 4) Smooth RMS values
@@ -161,6 +150,9 @@ void MainComponent::getNextAudioBlock(const juce::AudioSourceChannelInfo& buffer
 
     // 6) Calculate envelope
     calculateEnvelope(buffer, bufferToFill.startSample, bufferToFill.numSamples);
+
+    // 7) Publish for the UI: no lock, the audio thread never waits
+    publishedFeatures.write(features);
 }
 
 void MainComponent::releaseResources()
@@ -173,42 +165,23 @@ void MainComponent::releaseResources()
 void MainComponent::calculateInstantRms(const juce::AudioBuffer<float>* buffer,
     int startSample,
     int numSamples,
-    juce::Array<float>& instantRms)
+    MeterValues<>& instantRms)
 {
     if (buffer == nullptr || numSamples <= 0)
         return;
 
-    const int numChans = buffer->getNumChannels();
-    instantRms.clearQuick();
-    instantRms.insertMultiple(0, 0.0f, numChans);
-
-    for (int ch = 0; ch < numChans; ++ch)
-    {
-        const float* data = buffer->getReadPointer(ch, startSample);
-
-        double sumSquares = 0.0;
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float s = data[i];
-            sumSquares += (double)s * (double)s;
-        }
-        auto sumSquaresDiv = sumSquares / (double)numSamples;
-        const float rms = std::sqrt((float)sumSquaresDiv);
-        instantRms.set(ch, rms);
-    }
+    MeterKernel::computeRms(*buffer, startSample, numSamples, instantRms);
 }
 
-void MainComponent::smoothRmsValues(const juce::Array<float>& instantRms)
+void MainComponent::smoothRmsValues(const MeterValues<>& instantRms)
 {
-    const juce::SpinLock::ScopedLockType sl(rmsLock);
-    const float a = juce::jlimit(0.0f, 1.0f, rmsSmoothingAlpha);
+    const float a = juce::jlimit(0.0f, 1.0f, rmsSmoothingAlpha.read());
     const float b = 1.0f - a;
 
-    for (int ch = 0; ch < smoothedRms.size(); ++ch)
+    for (int ch = 0; ch < features.rms.size(); ++ch)
     {
-        const float sm = b * instantRms[ch] + a * smoothedRms[ch];
-        smoothedRms.set(ch, sm);
-        lastRms.set(ch, sm);
+        const float sm = b * instantRms[ch] + a * features.rms[ch];
+        features.rms.set(ch, sm);
     }
 }
 
@@ -233,8 +206,7 @@ void MainComponent::calculatePeak(const juce::AudioBuffer<float>* buffer,
         if (absS > peak) peak = absS;
     }
 
-    const juce::SpinLock::ScopedLockType sl(audioFeatLock);
-    lastPeak = peak;
+    features.peak = peak;
 }
 
 void MainComponent::calculateEnvelope(const juce::AudioBuffer<float>* buffer,
@@ -261,9 +233,8 @@ void MainComponent::calculateEnvelope(const juce::AudioBuffer<float>* buffer,
         localEnv = (float)(alpha * localEnv + (1.0 - alpha) * absS);
     }
 
-    const juce::SpinLock::ScopedLockType sl(audioFeatLock);
     envelopeState = localEnv;
-    lastEnvelope = localEnv;
+    features.envelope = localEnv;
 }
 
 //==============================================================================
@@ -381,10 +352,9 @@ void MainComponent::setButtonsEnabledState()
     }
 }
 
-juce::Array<float> MainComponent::getLatestRms() const
+MeterValues<> MainComponent::getLatestRms() const
 {
-    const juce::SpinLock::ScopedLockType sl(rmsLock);
-    return lastRms; // returns a copy
+    return publishedFeatures.read().rms; // returns a copy
 }
 
 void MainComponent::timerCallback()
@@ -492,7 +462,7 @@ void MainComponent::disconnectOsc()
     }
 }
 
-void MainComponent::sendRmsOverOsc(const juce::Array<float>& values)
+void MainComponent::sendRmsOverOsc(const MeterValues<>& values)
 {
     if (!oscConnected)
         return;
@@ -514,15 +484,11 @@ void MainComponent::sendAudioFeaturesOverOsc()
     if (!oscConnected)
         return;
 
-    auto rms = getLatestRms();
-
-    float peak = 0.0f;
-    float env = 0.0f;
-    {
-        const juce::SpinLock::ScopedLockType sl(audioFeatLock);
-        peak = lastPeak;
-        env = lastEnvelope;
-    }
+    // One snapshot: RMS, peak and envelope all come from the same audio block
+    const auto latest = publishedFeatures.read();
+    const auto& rms = latest.rms;
+    const float peak = latest.peak;
+    const float env = latest.envelope;
 
     juce::String rmsAddr = oscAddress.isEmpty() ? "/audio/rms" : (oscAddress + "/rms");
     juce::OSCMessage rmsMsg(rmsAddr);
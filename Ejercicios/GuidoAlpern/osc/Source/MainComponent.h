@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../../Utils/DSP/RealtimeParams.h"
+#include "../../../../Utils/DSP/MeterValues.h"
+#include "../../../../Utils/DSP/MeterKernel.h"
 
 // PROJUCER needs to add juce_osc
 
@@ -25,8 +28,8 @@ public:
     void setupGuiComponents();
     void setupAudioPlayer();
 
-    // Access latest RMS values (per-channel). Thread-safe snapshot.
-    juce::Array<float> getLatestRms() const;
+    // Access latest RMS values (per-channel). Lock-free snapshot, UI thread only.
+    MeterValues<> getLatestRms() const;
 
 private:
     //==============================================================================
@@ -71,23 +74,25 @@ private:
     /// OSC helpers
     void updateOscConnection();
     void disconnectOsc();
-    void sendRmsOverOsc (const juce::Array<float>& values);
+    void sendRmsOverOsc (const MeterValues<>& values);
     void reconnectOscIfEnabled();
     void handleOscEnableToggleClicked(); // extracted handler
 
     // New: send combined audio features over OSC (RMS + peak + envelope)
     void sendAudioFeaturesOverOsc();
 
-    // Metering: latest RMS per channel (smoothed), protected by a lock for cross-thread access
-    mutable juce::SpinLock rmsLock;
-    juce::Array<float> lastRms;
-    juce::Array<float> smoothedRms;
-    float rmsSmoothingAlpha = 0.2f;
-    
-    // New: simple audio features (peak + envelope) with a separate lock
-    mutable juce::SpinLock audioFeatLock;
-    float lastPeak { 0.0f };        // last block peak (0..1)
-    float lastEnvelope { 0.0f };    // envelope follower state (0..1)
+    // Metering: the audio thread owns the features and publishes a copy of all of them once
+    // per block; the UI reads the latest one without locking or allocating
+    struct AudioFeatures
+    {
+        MeterValues<> rms;          // latest RMS per channel (smoothed)
+        float peak { 0.0f };        // last block peak (0..1)
+        float envelope { 0.0f };    // envelope follower state (0..1)
+    };
+
+    AudioFeatures features;                                  // audio thread only
+    mutable RealtimeParams<AudioFeatures> publishedFeatures; // audio thread -> UI
+    RealtimeParams<float> rmsSmoothingAlpha { 0.2f }; // slider -> audio thread
     float envelopeState { 0.0f };   // running state on audio thread
     float envelopeTauSec { 0.01f }; // time constant in seconds
     double currentSampleRate { 44100.0 };
@@ -98,9 +103,9 @@ private:
     void calculateInstantRms(const juce::AudioBuffer<float>* buffer,
         int startSample,
         int numSamples,
-        juce::Array<float>& instantRms);
+        MeterValues<>& instantRms);
 
-    void smoothRmsValues(const juce::Array<float>& instantRms);
+    void smoothRmsValues(const MeterValues<>& instantRms);
 
     void calculatePeak(const juce::AudioBuffer<float>* buffer,
         int startSample,
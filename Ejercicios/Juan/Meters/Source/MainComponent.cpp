@@ -36,13 +36,13 @@ void MainComponent::setupGuiComponents()
     smoothingSlider.setRange (0.0, 1.0, 0.001);
 
     // Invert mapping: slider shows "smoothing amount", alpha is "snappiness".
-    smoothingSlider.setValue (rmsSmoothingAlpha, juce::dontSendNotification);
+    smoothingSlider.setValue (rmsSmoothingAlpha.getLastWritten(), juce::dontSendNotification);
     smoothingSlider.setTextValueSuffix ("");
     smoothingSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 60, 20);
     smoothingSlider.onValueChange = [this]
     {
         const double sliderVal = smoothingSlider.getValue();
-        rmsSmoothingAlpha = (float) (sliderVal);
+        rmsSmoothingAlpha.write ((float) sliderVal);
     };
     addAndMakeVisible (smoothingSlider);
 
@@ -82,13 +82,7 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     if (auto* dev = deviceManager.getCurrentAudioDevice())
         numOutChans = juce::jmax (1, dev->getActiveOutputChannels().countNumberOfSetBits());
 
-    {
-        const juce::SpinLock::ScopedLockType sl (rmsLock);
-        lastRms.clearQuick();
-        smoothedRms.clearQuick();
-        lastRms.insertMultiple (0, 0.0f, numOutChans);
-        smoothedRms.insertMultiple (0, 0.0f, numOutChans);
-    }
+    smoothedRms.reset (numOutChans); // up to MeterValues<>::maxChannels
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
@@ -98,10 +92,9 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     {
         bufferToFill.clearActiveBufferRegion();
         // Also reset RMS to zero when no source
-        const juce::SpinLock::ScopedLockType sl (rmsLock);
         for (int c = 0; c < smoothedRms.size(); ++c)
             smoothedRms.set (c, 0.0f);
-        lastRms = smoothedRms;
+        publishedRms.write (smoothedRms);
         return;
     }
 
@@ -112,41 +105,25 @@ void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& buffe
     if (buffer == nullptr || bufferToFill.numSamples <= 0)
         return;
 
-    const int numChans = buffer->getNumChannels();
     const int n = bufferToFill.numSamples;
     const int start = bufferToFill.startSample;
 
     // 3) Calculate instant RMS
-    juce::Array<float> instantRms;
-    instantRms.insertMultiple (0, 0.0f, numChans);
+    MeterValues<> instantRms; // fixed array: nothing allocated per block
+    MeterKernel::computeRms (*buffer, start, n, instantRms);
 
-    for (int ch = 0; ch < numChans; ++ch)
+    // Exponential smoothing and publish (wait-free: the UI never holds up the audio thread)
     {
-        const float* data = buffer->getReadPointer (ch, start);
-
-        double sumSquares = 0.0;
-        for (int i = 0; i < n; ++i) // n = bufferSize
-        {
-            const float s = data[i];
-            sumSquares += (double) s * (double) s;
-        }
-        auto sumSquaresDiv = sumSquares / (double) n;
-        const float rms = std::sqrt ((float) sumSquaresDiv);
-        instantRms.set (ch, rms);
-    }
-
-    // Exponential smoothing and publishs
-    {
-        const juce::SpinLock::ScopedLockType sl (rmsLock); // Lock
-        const float a = juce::jlimit (0.0f, 1.0f, rmsSmoothingAlpha);
+        const float a = juce::jlimit (0.0f, 1.0f, rmsSmoothingAlpha.read());
         const float b = 1.0f - a;
 
         for (int ch = 0; ch < smoothedRms.size(); ++ch)
         {
             const float sm = b * instantRms[ch] + a * smoothedRms[ch];
             smoothedRms.set (ch, sm);
-            lastRms.set (ch, sm);
         }
+
+        publishedRms.write (smoothedRms);
     }
 }
 
@@ -189,7 +166,7 @@ void MainComponent::paint (juce::Graphics& g)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
     auto bounds = getLocalBounds().reduced (20);
-    auto rmsValues = lastRms;   // use smoothed RMS
+    auto rmsValues = getLatestRms();   // use smoothed RMS
 
     const int numCircles = juce::jmax (1, rmsValues.size());
     auto area = bounds;
@@ -286,10 +263,9 @@ void MainComponent::setButtonsEnabledState()
     }
 }
 
-juce::Array<float> MainComponent::getLatestRms() const
+MeterValues<> MainComponent::getLatestRms() const
 {
-    const juce::SpinLock::ScopedLockType sl (rmsLock);
-    return lastRms; // returns a copy
+    return publishedRms.read(); // a copy of the latest block's values, no allocation
 }
 
 void MainComponent::timerCallback()
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../../Utils/DSP/RealtimeParams.h"
+#include "../../../../Utils/DSP/MeterValues.h"
+#include "../../../../Utils/DSP/MeterKernel.h"
 
 //==============================================================================
 /*
@@ -28,8 +31,8 @@ public:
     void setupGuiComponents();
     void setupAudioPlayer();
 
-    // Access latest RMS values (per-channel). Thread-safe snapshot.
-    juce::Array<float> getLatestRms() const;
+    // Access latest RMS values (per-channel). Lock-free snapshot, UI thread only.
+    MeterValues<> getLatestRms() const;
 
 private:
     //==============================================================================
@@ -55,11 +58,11 @@ private:
     void loadURL (const juce::URL& url);
     void setButtonsEnabledState();
 
-    // Metering: latest RMS per channel (smoothed), protected by a lock for cross-thread access
-    mutable juce::SpinLock rmsLock;
-    juce::Array<float> lastRms;
-    juce::Array<float> smoothedRms;
-    float rmsSmoothingAlpha = 0.2f;
+    // Metering: smoothed RMS per channel. The audio thread owns smoothedRms and publishes a
+    // copy every block; the UI reads the latest one without locking or allocating
+    MeterValues<> smoothedRms;                          // audio thread only
+    mutable RealtimeParams<MeterValues<>> publishedRms; // audio thread -> UI
+    RealtimeParams<float> rmsSmoothingAlpha { 0.2f }; // slider -> audio thread
 
     // Timer: drive UI meter updates
     void timerCallback() override;
@@ -44,17 +44,17 @@ MainComponent::MainComponent()
     depthSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     depthSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
     depthSlider.setRange(0.0, 20.0, 0.01);
-    depthSlider.setValue(depthMs);
+    depthSlider.setValue(flangerParams.getLastWritten().depthMs);
 
     rateSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     rateSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
     rateSlider.setRange(0.01, 10.0, 0.01);
-    rateSlider.setValue(lfoRateHz);
+    rateSlider.setValue(flangerParams.getLastWritten().lfoRateHz);
 
     feedbackSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     feedbackSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 70, 20);
     feedbackSlider.setRange(0.0, 0.95, 0.001);
-    feedbackSlider.setValue(feedback);
+    feedbackSlider.setValue(flangerParams.getLastWritten().feedback);
 
     // Labels
     mixLabel.attachToComponent(&mixSlider, false);
@@ -84,8 +84,11 @@ MainComponent::MainComponent()
 
     mixSlider.onValueChange = [this] // El slider que agregué
         {
-            wetMix = (float)mixSlider.getValue(); // El slider controla el valor de wet
-            dryMix = 1.0f - wetMix; // los dos suman 1
+            flangerParams.update([this](FlangerParams& p)
+                {
+                    p.wetMix = (float)mixSlider.getValue(); // El slider controla el valor de wet
+                    p.dryMix = 1.0f - p.wetMix; // los dos suman 1
+                });
         };
     /*
     delayTimeSlider.onValueChange = [this]
@@ -103,21 +106,31 @@ MainComponent::MainComponent()
      */
     depthSlider.onValueChange = [this]
         {
-            depthMs = (float)depthSlider.getValue();
+            flangerParams.update([this](FlangerParams& p) { p.depthMs = (float)depthSlider.getValue(); });
         };
 
     rateSlider.onValueChange = [this]
         {
-            lfoRateHz = (float)rateSlider.getValue();
-
-            if (currentSampleRate > 0)
-                lfoIncrement = juce::MathConstants<float>::twoPi * (lfoRateHz / currentSampleRate);
+            flangerParams.update([this](FlangerParams& p) { p.lfoRateHz = (float)rateSlider.getValue(); });
         };
 
     feedbackSlider.onValueChange = [this]
         {
-            feedback = (float)feedbackSlider.getValue();
+            flangerParams.update([this](FlangerParams& p) { p.feedback = (float)feedbackSlider.getValue(); });
+        };
+
+    shapeBox.addItem("Sine", 1);
+    shapeBox.addItem("Triangle", 2);
+    shapeBox.addItem("Saw", 3);
+    shapeBox.addItem("Random", 4);
+    shapeBox.addItem("Sample & Hold", 5);
+    shapeBox.setSelectedId(1, juce::dontSendNotification);
+    shapeBox.onChange = [this]
+        {
+            // los ids siguen el orden de LfoShape
+            flangerParams.update([this](FlangerParams& p) { p.lfoShape = (LfoShape)(shapeBox.getSelectedId() - 1); });
         };
+    addAndMakeVisible(shapeBox);
 
     setButtonsEnabledState();
 
@@ -155,44 +168,8 @@ void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate
 
     // Ensure delaySamples matches current delayTimeMs
     //delayTimeSlider.onValueChange();
-    // Calculo el paso del LFO en radianes por muestra.
-    lfoIncrement = juce::MathConstants<float>::twoPi * (lfoRateHz / currentSampleRate);
-    lfoPhase = 0.0f;
-}
-/*
-float MainComponent::processLFO()
-{
-    // Triangular unipolar 0..1..0..1..
-    float value;
-
-    if (lfoPhase < juce::MathConstants<float>::pi)
-        value = lfoPhase / juce::MathConstants<float>::pi;               // Subida 0→1
-    else
-        value = 2.0f - (lfoPhase / juce::MathConstants<float>::pi);      // Bajada 1→0
-
-    // Avanza fase
-    lfoPhase += lfoIncrement;
-    if (lfoPhase >= juce::MathConstants<float>::twoPi)
-        lfoPhase -= juce::MathConstants<float>::twoPi;
-
-    return value; // Unipolar 0..1
-}
-*/
-// El código comentado arriba es para que el lfo sea triangular
-float MainComponent::processLFO()
-{
-    // LFO senoidal
-    // el seno da valores en (-1,1)
-    // le sumo 1 y da valores en (0,2)
-    // lo multiplico por 0.5 y queda en (0,1)
-    float value = 0.5f * (1.0f + std::sin(lfoPhase));
-
-    // incremento la fase
-    lfoPhase += lfoIncrement;
-    if (lfoPhase >= juce::MathConstants<float>::twoPi)
-        lfoPhase -= juce::MathConstants<float>::twoPi;
-
-    return value;
+    // El LFO arranca en fase 0 (la frecuencia se pasa en cada bloque)
+    lfo.prepare(sampleRate);
 }
 
 
@@ -208,21 +185,14 @@ void MainComponent::prepareDelayState()
     // (pero requiere que el tamaño del buffer sea potencia de 2).
     // quiero que maxDelaySamples sea una potencia de 2
     int samplesNeeded = (int)std::ceil(maxDelaySeconds * currentSampleRate);
-    // fuerzo a que sea la potencia de dos más cercana por encima del tamaño máximo deseado
-    maxDelaySamples = juce::nextPowerOfTwo(samplesNeeded);
-
-
-    delayBuffer.assign((size_t)maxDelaySamples, 0.0f);
-
-    delayMask = maxDelaySamples - 1;
-
-    writePos = 0;
+    // DelayLine redondea a la potencia de dos siguiente y arma la máscara
+    delayLine.prepare(samplesNeeded, 1);
 
 }
 
 void MainComponent::processFlangerChannel(juce::AudioBuffer<float>& buffer, int channelNum)
 {
-    if (buffer.getNumSamples() <= 0 || delayBuffer.empty())
+    if (buffer.getNumSamples() <= 0 || !delayLine.isPrepared())
         return;
 
     if (channelNum < 0 || channelNum >= buffer.getNumChannels())
@@ -230,61 +200,41 @@ void MainComponent::processFlangerChannel(juce::AudioBuffer<float>& buffer, int
 
     auto* data = buffer.getWritePointer(channelNum);
     const int numSamples = buffer.getNumSamples();
-    // delayBuffSize es constante, definido en funcion del maximo de delay permitido (2s.)
-    const int delayBuffSize = (int)delayBuffer.size();
+
+    // Parámetros, frecuencia y forma del LFO, una vez por bloque
+    const auto& params = flangerParams.read();
+    lfo.setFrequency(0, params.lfoRateHz);
+    lfo.setShape(0, params.lfoShape);
+
+    float lfoBlock[lfoChunkSize];
 
     for (int i = 0; i < numSamples; ++i)
     {
-        /*
-        int readPos = writePos - delaySamples;
-        if (readPos < 0)
-            readPos += delayBuffSize;
-        */
-        //int readPos = (writePos - delaySamples) & delayMask; // se hace wire-AND con la máscara
-        
-        float lfoValue = processLFO(); // Obtengo el valor del LFO entre 0 y 1
+        // Genero los valores del LFO de a tramos de lfoChunkSize muestras
+        const int k = i % lfoChunkSize;
+        if (k == 0)
+            lfo.process(lfoBlock, juce::jmin(lfoChunkSize, numSamples - i));
+
+        // el LFO da valores en (-1,1): le sumo 1 y multiplico por 0.5 para que quede en (0,1)
+        float lfoValue = 0.5f * (1.0f + lfoBlock[k]);
 
         // Calculo delay actual modulado por el lfo
-        float currentDelayMs = depthMs * lfoValue; // un valor entre 0 y Depth (en milisegundos)
+        float currentDelayMs = params.depthMs * lfoValue; // un valor entre 0 y Depth (en milisegundos)
         float delaySamples = (currentDelayMs * 0.001f) * currentSampleRate; // paso a muestras (pasando primero por segundos)
 
-        // Calculo la posición de lectura con precisión flotante
-        float readPosFloat = (float)writePos - delaySamples;
+        // Lectura fraccionaria con interpolación lineal (wrap por bitmask dentro de DelayLine)
+        float delayed = delayLine.read(0, delaySamples);
 
-        // Ajustamos para wrap-around manual si es negativo
-        if (readPosFloat < 0.0f)
-            readPosFloat += (float)maxDelaySamples;
-
-        // Índices enteros para interpolación
-        int idxA = (int)readPosFloat;
-        int idxB = (idxA + 1) & delayMask;
-
-        // Parte fraccionaria
-        float frac = readPosFloat - (float)idxA;
-
-        // Interpolación lineal
-        float delayed =
-            delayBuffer[(size_t)idxA] * (1.0f - frac) +
-            delayBuffer[(size_t)idxB] * frac;
-
-        //const float in = data[i]; // read data from buffer
         float in = data[i];
 
-        delayBuffer[(size_t)writePos] = in + feedback * delayed;
+        delayLine.write(0, in + params.feedback * delayed);
 
         // Output write to streaming AudioBuffer: dry + wet (fixed 50/50)
         // data[i] = in + delayed;
-        data[i] = dryMix * in + wetMix * delayed; // Para poder controlar la mezcla dry/ wet
-        //data[i] = delayed; /// Test only delay
-
-        // advance circular index (0-88199)
-        /*
-        writePos = writePos + 1;
-        if (writePos == delayBuffSize)
-            writePos = 0;
-        */
-        // cambié el if por bitmask
-        writePos = (writePos + 1) & delayMask;
+        data[i] = params.dryMix * in + params.wetMix * delayed; // Para poder controlar la mezcla dry/ wet
+
+        // avanzo el índice circular
+        delayLine.advance();
     }
 }
 
@@ -318,9 +268,7 @@ void MainComponent::releaseResources()
     transport.releaseResources();
 
     // Clear delay buffers
-    delayBuffer.clear();
-    writePos = 0;
-    maxDelaySamples = 0;
+    delayLine.release();
 }
 
 //==============================================================================
@@ -341,6 +289,8 @@ void MainComponent::resized()
     playButton.setBounds(row.removeFromLeft(120));
     row.removeFromLeft(10);
     stopButton.setBounds(row.removeFromLeft(120));
+    row.removeFromLeft(20);
+    shapeBox.setBounds(row.removeFromLeft(160));
 
     area.removeFromTop(10);
 
@@ -441,4 +391,5 @@ void MainComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
             transport.setPosition(0.0);
         setButtonsEnabledState();
     }
+
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../../Utils/DSP/DelayLine.h"
+#include "../../../Utils/DSP/LfoBank.h"
+#include "../../../Utils/DSP/RealtimeParams.h"
 
 //==============================================================================
 /*
@@ -58,6 +61,9 @@ private:
     juce::Slider feedbackSlider{ juce::Slider::RotaryHorizontalVerticalDrag, juce::Slider::TextBoxBelow };
     juce::Label  feedbackLabel{ {}, "Feedback" };
 
+    // Forma de onda del LFO (seno, triangular, diente de sierra, random, S&H)
+    juce::ComboBox shapeBox;
+
     // ChangeListener (to observe transport state changes)
     void changeListenerCallback(juce::ChangeBroadcaster* source) override;
 
@@ -67,38 +73,38 @@ private:
     void setButtonsEnabledState();
 
     //==============================================================================
-    // Parameters (controlados por sliders)
-    float wetMix = 0.5f; // Agregado: wetMix y dryMix para la mezcla dry/wet
-    float dryMix = 0.5f;
-    //float delayTimeMs = 400.0f;  // delay time in milliseconds (mapped to delaySamples)
-    float depthMs = 5.0f;  // 0–20 ms
-    float lfoRateHz = 0.5f;  // 0.01–10 Hz
-    float feedback = 0.35f;   // 0..<1
+    // Parameters (controlados por sliders): los sliders y el combo publican una copia
+    // completa y el audio thread la lee una vez por bloque, sin locks (ver RealtimeParams)
+    struct FlangerParams
+    {
+        float wetMix = 0.5f; // Agregado: wetMix y dryMix para la mezcla dry/wet
+        float dryMix = 0.5f;
+        //float delayTimeMs = 400.0f;  // delay time in milliseconds (mapped to delaySamples)
+        float depthMs = 5.0f;  // 0–20 ms
+        float lfoRateHz = 0.5f;  // 0.01–10 Hz
+        float feedback = 0.35f;   // 0..<1
+        LfoShape lfoShape = LfoShape::Sine;
+    };
+    RealtimeParams<FlangerParams> flangerParams;
 
-    float lfoPhase = 0.0f;
-    float lfoIncrement = 0.0f;
+    // El LFO sale de LfoBank (Utils/DSP/LfoBank.h): genera un bloque entero de valores
+    // de una vez, sin un std::sin por muestra
+    LfoBank<1> lfo;
+    static constexpr int lfoChunkSize = 256;
 
 
 
 
     
 
-    // Delay buffer (single channel)
-    std::vector<float> delayBuffer;
-    int writePos = 0;
-    //int delaySamples = 22050;      // default (0.5s @ 44.1kHz); clamped in prepare
-
-    // Limits and rate
-    int maxDelaySamples = 0;
-
-    // para el wire-AND-ing
-    int delayMask = 0;
+    // Delay buffer (single channel): buffer potencia de 2 con wrap por bitmask
+    // e interpolación lineal, compartido con DelayApp (Utils/DSP/DelayLine.h)
+    DelayLine<float, DelayLineInterpolation::Linear> delayLine;
 
     double currentSampleRate = 44100.0;
 
     void prepareDelayState();
     void processFlangerChannel(juce::AudioBuffer<float>& buffer, int channelNum);
-    float processLFO();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Notas programadas del arpegiador que todavía no salieron.
+//
+// Con gate, swing y ratchets una nota puede empezar o terminar después del bloque en el
+// que cae su paso. La cola guarda note-ons y note-offs con su tiempo absoluto en
+// muestras (contadas desde prepareToPlay) y processBlock saca los que caen en cada
+// bloque, así el note-off llega en la muestra exacta aunque sea varios bloques después.
+//
+// Capacidad fija y ordenada por tiempo (a igual tiempo, los note-offs antes que los
+// note-ons): sin memoria dinámica en el audio thread.
+class ArpNoteQueue
+{
+public:
+    static constexpr int capacity = 512;
+
+    struct Event
+    {
+        juce::int64 time;
+        int note;
+        int channel;
+        int velocity;       // 0 = note-off
+    };
+
+    ArpNoteQueue() = default;
+
+    void clear() noexcept                   { numEvents = 0; }
+    bool isEmpty() const noexcept           { return numEvents == 0; }
+    int  size() const noexcept              { return numEvents; }
+
+    // Programa una nota (note-on y note-off). Devuelve false si la cola está llena.
+    bool addNote (juce::int64 onTime, juce::int64 offTime, int note, int channel, int velocity) noexcept
+    {
+        if (numEvents + 2 > capacity)
+            return false;
+
+        // Si la misma nota todavía tiene un note-off pendiente después de este note-on,
+        // lo adelantamos: si no, cortaría la nota nueva
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const auto& e = events[i];
+
+            if (e.velocity == 0 && e.note == note && e.channel == channel && e.time > onTime)
+            {
+                auto moved = e;
+                moved.time = onTime;
+                removeAt (i);
+                insert (moved);
+            }
+        }
+
+        insert ({ onTime, note, channel, juce::jlimit (1, 127, velocity) });
+        insert ({ juce::jmax (onTime + 1, offTime), note, channel, 0 });
+        return true;
+    }
+
+    // Deja solo los note-offs de las notas que ya sonaron, todos en `time`: al volver a
+    // preparar, lo que está sonando se apaga al principio del bloque siguiente. Los
+    // note-ons pendientes se descartan junto con su note-off.
+    void flushNoteOffs (juce::int64 time) noexcept
+    {
+        bool pendingOn[16][128] {};
+        int kept = 0;
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            auto e = events[i];
+            auto& pending = pendingOn[juce::jlimit (1, 16, e.channel) - 1][juce::jlimit (0, 127, e.note)];
+
+            if (e.velocity > 0)
+            {
+                pending = true;
+                continue;
+            }
+
+            if (pending)
+            {
+                pending = false; // el note-off de un note-on descartado
+                continue;
+            }
+
+            e.time = time;
+            events[kept++] = e;
+        }
+
+        numEvents = kept;
+    }
+
+    // Saca en orden los eventos anteriores a endTime y llama a fn (event) con cada uno
+    template <typename Function>
+    void popUntil (juce::int64 endTime, Function&& fn) noexcept
+    {
+        int n = 0;
+
+        while (n < numEvents && events[n].time < endTime)
+            fn (events[n++]);
+
+        if (n > 0)
+        {
+            std::move (events + n, events + numEvents, events);
+            numEvents -= n;
+        }
+    }
+
+private:
+    Event events[capacity] {};
+    int numEvents = 0;
+
+    static bool goesBefore (const Event& a, const Event& b) noexcept
+    {
+        if (a.time != b.time)
+            return a.time < b.time;
+
+        return a.velocity == 0 && b.velocity != 0;
+    }
+
+    void insert (const Event& e) noexcept
+    {
+        jassert (numEvents < capacity);
+
+        // después de todos los que no van después de e: a igual orden, el primero que llegó
+        int pos = numEvents;
+        while (pos > 0 && goesBefore (e, events[pos - 1]))
+            --pos;
+
+        std::move_backward (events + pos, events + numEvents, events + numEvents + 1);
+        events[pos] = e;
+        ++numEvents;
+    }
+
+    void removeAt (int index) noexcept
+    {
+        std::move (events + index + 1, events + numEvents, events + index);
+        --numEvents;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ArpNoteQueue)
+};
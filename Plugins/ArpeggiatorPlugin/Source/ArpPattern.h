@@ -0,0 +1,180 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Patrones del arpegiador: qué hace cada paso además de elegir la nota.
+//
+// Un patrón es una lista de hasta maxSteps pasos, cada uno con gate (fracción del paso),
+// velocity (escala la de la tecla), octava, ratchets (repeticiones dentro del paso) y
+// probabilidad de sonar. La dirección (Up, Down, ...) sigue eligiendo la nota.
+struct ArpPatternStep
+{
+    float gate        = 1.0f;   // 0 .. 1 del paso (o de cada ratchet)
+    float velocity    = 1.0f;   // escala la velocity de la tecla
+    int   octave      = 0;      // -2 .. +2
+    int   ratchets    = 1;      // 1 .. maxRatchets notas repartidas en el paso
+    float probability = 1.0f;   // 0 .. 1
+};
+
+struct ArpPattern
+{
+    static constexpr int maxSteps    = 16;
+    static constexpr int maxRatchets = 4;
+
+    int numSteps = 1;
+    ArpPatternStep steps[maxSteps];
+
+    //==============================================================================
+    // Patrones de fábrica (el parámetro PATTERN elige uno)
+    static juce::StringArray getPresetNames()
+    {
+        return { "Straight", "Accents", "Octaves", "Ratchets", "Staccato", "Sparse" };
+    }
+
+    static ArpPattern getPreset (int index)
+    {
+        ArpPattern p;
+
+        switch (index)
+        {
+            case 1: // Accents: fuerte, débil, medio, débil
+                p.numSteps = 4;
+                p.steps[0] = { 1.0f,  1.0f,  0, 1, 1.0f };
+                p.steps[1] = { 0.5f,  0.55f, 0, 1, 1.0f };
+                p.steps[2] = { 0.75f, 0.8f,  0, 1, 1.0f };
+                p.steps[3] = { 0.5f,  0.55f, 0, 1, 1.0f };
+                break;
+
+            case 2: // Octaves: cada nota y su octava de arriba
+                p.numSteps = 2;
+                p.steps[0] = { 0.9f, 1.0f,  0, 1, 1.0f };
+                p.steps[1] = { 0.9f, 0.8f,  1, 1, 1.0f };
+                break;
+
+            case 3: // Ratchets: repeticiones que se aceleran al final del compás
+                p.numSteps = 8;
+                for (int i = 0; i < 8; ++i)
+                    p.steps[i] = { 0.6f, i % 2 == 0 ? 1.0f : 0.7f, 0, 1, 1.0f };
+                p.steps[3].ratchets = 2;
+                p.steps[6].ratchets = 3;
+                p.steps[7].ratchets = 4;
+                break;
+
+            case 4: // Staccato
+                p.numSteps = 1;
+                p.steps[0] = { 0.25f, 1.0f, 0, 1, 1.0f };
+                break;
+
+            case 5: // Sparse: no todos los pasos suenan
+                p.numSteps = 8;
+                p.steps[0] = { 0.8f, 1.0f,  0, 1, 1.0f };
+                p.steps[1] = { 0.5f, 0.6f,  0, 1, 0.5f };
+                p.steps[2] = { 0.8f, 0.8f,  0, 1, 0.8f };
+                p.steps[3] = { 0.5f, 0.6f,  1, 1, 0.4f };
+                p.steps[4] = { 0.8f, 0.9f,  0, 1, 1.0f };
+                p.steps[5] = { 0.5f, 0.6f,  0, 2, 0.3f };
+                p.steps[6] = { 0.8f, 0.8f, -1, 1, 0.7f };
+                p.steps[7] = { 0.5f, 0.6f,  0, 1, 0.5f };
+                break;
+
+            default: // Straight: como el arpegiador sin patrón
+                break;
+        }
+
+        return p;
+    }
+};
+
+//==============================================================================
+// Un patrón "compilado": la tabla plana que usa el scheduler en cada paso.
+//
+// compile() se llama sólo cuando cambia el patrón, el gate o el swing, y deja resuelto
+// para cada paso (y cada paridad, por el swing) dónde empieza y cuánto dura cada nota,
+// en fracciones del paso. En el audio thread un paso es indexar la tabla: un patrón con
+// ratchets, swing y probabilidades cuesta lo mismo por paso que Up a gate fijo.
+class ArpPatternTable
+{
+public:
+    struct Event
+    {
+        float offset;       // inicio, en pasos desde el paso de la grilla
+        float length;       // duración, en pasos
+        float velocity;     // escala
+        int   octave;
+    };
+
+    struct Step
+    {
+        const Event* events;
+        int   numEvents;
+        float probability;
+    };
+
+    ArpPatternTable()
+    {
+        compile (ArpPattern::getPreset (0), 1.0f, 0.0f);
+    }
+
+    // gate global (escala el de cada paso) y swing: los pasos impares se atrasan
+    // swing pasos (0 .. 0.5), así el par queda largo-corto
+    void compile (const ArpPattern& pattern, float gate, float swing) noexcept
+    {
+        numSteps = juce::jlimit (1, ArpPattern::maxSteps, pattern.numSteps);
+        gate  = juce::jlimit (0.05f, 1.0f, gate);
+        swing = juce::jlimit (0.0f, 0.5f, swing);
+
+        for (int parity = 0; parity < 2; ++parity)
+        {
+            // el paso par dura hasta que empieza el impar (atrasado); el impar hasta el próximo par
+            const float start = parity == 0 ? 0.0f : swing;
+            const float span  = parity == 0 ? 1.0f + swing : 1.0f - swing;
+
+            for (int s = 0; s < numSteps; ++s)
+            {
+                const auto& step = pattern.steps[s];
+                const int ratchets = juce::jlimit (1, ArpPattern::maxRatchets, step.ratchets);
+                const float slot = span / (float) ratchets;
+
+                auto& entry = steps[parity][s];
+                entry.firstEvent  = (parity * ArpPattern::maxSteps + s) * ArpPattern::maxRatchets;
+                entry.numEvents   = ratchets;
+                entry.probability = juce::jlimit (0.0f, 1.0f, step.probability);
+
+                for (int r = 0; r < ratchets; ++r)
+                {
+                    auto& e = events[entry.firstEvent + r];
+                    e.offset   = start + (float) r * slot;
+                    e.length   = slot * juce::jlimit (0.05f, 1.0f, step.gate) * gate;
+                    e.velocity = juce::jmax (0.0f, step.velocity);
+                    e.octave   = juce::jlimit (-2, 2, step.octave);
+                }
+            }
+        }
+    }
+
+    // Paso número `step` de la grilla (el patrón se repite cada numSteps pasos)
+    Step getStep (juce::int64 step) const noexcept
+    {
+        const int parity = (int) (step & 1);
+        const int index  = (int) (((step % numSteps) + numSteps) % numSteps); // step < 0 en el pre-roll del host
+        const auto& entry = steps[parity][index];
+        return { events + entry.firstEvent, entry.numEvents, entry.probability };
+    }
+
+    int getNumSteps() const noexcept    { return numSteps; }
+
+private:
+    struct Entry
+    {
+        int   firstEvent  = 0;
+        int   numEvents   = 0;
+        float probability = 1.0f;
+    };
+
+    Entry steps[2][ArpPattern::maxSteps];
+    Event events[2 * ArpPattern::maxSteps * ArpPattern::maxRatchets] {};
+    int numSteps = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ArpPatternTable)
+};
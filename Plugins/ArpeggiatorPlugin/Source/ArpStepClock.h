@@ -0,0 +1,182 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Reloj de pasos del arpegiador.
+//
+// En vez de recorrer el bloque muestra por muestra descontando un contador, calcula
+// directamente en qué muestras del bloque caen los pasos. El costo por bloque es
+// O(pasos) en lugar de O(numSamples).
+//
+// La posición del próximo paso es exacta (double, en muestras desde el inicio del
+// bloque) y el largo del paso no se redondea: cada paso suena en la muestra más cercana
+// a su posición exacta, y el siguiente se cuenta desde la posición exacta, así que el
+// error nunca pasa de media muestra ni se acumula. Con valores enteros da el
+// mismo timing que el contador por muestra original (advanceBySample).
+namespace ArpStepClock
+{
+    // Llama a onStep (offset) por cada paso dentro del bloque y devuelve la posición del
+    // próximo paso relativa al bloque siguiente.
+    // Una posición < -0.5 es un paso atrasado (p.ej. -1 = "disparar ya"): suena en la
+    // muestra 0 y la grilla sigue desde ahí.
+    template <typename StepFunction>
+    inline double advance (double nextStepPosition, double samplesPerStep, int numSamples, StepFunction&& onStep)
+    {
+        jassert (samplesPerStep >= 1.0);
+
+        if (numSamples <= 0)
+            return nextStepPosition;
+
+        double pos = nextStepPosition < -0.5 ? 0.0 : nextStepPosition;
+
+        for (;;)
+        {
+            const int offset = (int) std::floor (pos + 0.5);
+
+            if (offset >= numSamples)
+                break;
+
+            onStep (offset);
+            pos += samplesPerStep;
+        }
+
+        return pos - numSamples;
+    }
+
+    // Varios relojes a la vez (uno por carril del arpegiador), en una sola pasada por los
+    // pasos del bloque: en cada vuelta suena el carril con el paso más cercano (a igual
+    // muestra, el de número más bajo), así onStep (lane, offset) llega en orden de tiempo.
+    // Cada carril sigue las mismas reglas que advance(); positions[lane] queda relativa al
+    // bloque siguiente.
+    template <int MaxLanes, typename StepFunction>
+    inline void advanceLanes (double (&positions)[MaxLanes], const double (&samplesPerStep)[MaxLanes],
+                              int numLanes, int numSamples, StepFunction&& onStep)
+    {
+        jassert (numLanes <= MaxLanes);
+
+        if (numSamples <= 0)
+            return;
+
+        int offsets[MaxLanes];
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            jassert (samplesPerStep[lane] >= 1.0);
+
+            if (positions[lane] < -0.5)
+                positions[lane] = 0.0;
+
+            offsets[lane] = (int) std::floor (positions[lane] + 0.5);
+        }
+
+        for (;;)
+        {
+            int next = -1;
+            int nextOffset = numSamples;
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                if (offsets[lane] < nextOffset)
+                {
+                    next = lane;
+                    nextOffset = offsets[lane];
+                }
+            }
+
+            if (next < 0)
+                break;
+
+            onStep (next, nextOffset);
+
+            positions[next] += samplesPerStep[next];
+            offsets[next] = (int) std::floor (positions[next] + 0.5);
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            positions[lane] -= numSamples;
+    }
+
+    // El contador por muestra original (samplesUntilNextStep = posición + 1): referencia
+    // para comparar en el benchmark
+    template <typename StepFunction>
+    inline int advanceBySample (int samplesUntilNextStep, int samplesPerStep, int numSamples, StepFunction&& onStep)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            samplesUntilNextStep -= 1;
+
+            if (samplesUntilNextStep <= 0)
+            {
+                onStep (i);
+                samplesUntilNextStep = samplesPerStep;
+            }
+        }
+
+        return samplesUntilNextStep;
+    }
+
+    //==============================================================================
+    // Benchmark: ns por bloque de los dos métodos, bloques de 32 a 8192 muestras
+    // (1/32 a 120 BPM y 48 kHz: un paso cada 3000 muestras). También verifica que los
+    // offsets de los pasos sean idénticos; devuelve false si no lo son. Lo corre la app
+    // de consola Benchmarks.
+    inline bool logBenchmark (int samplesPerStep = 3000, int totalSamples = 1 << 24)
+    {
+        bool passed = true;
+
+        for (int blockSize = 32; blockSize <= 8192; blockSize *= 2)
+        {
+            const int numBlocks = totalSamples / blockSize;
+            juce::int64 checksum[2] = { 0, 0 };
+            double seconds[2] = { 0.0, 0.0 };
+            bool identical = true;
+
+            std::vector<int> steps[2];
+            steps[0].reserve (64);
+            steps[1].reserve (64);
+
+            for (int method = 0; method < 2; ++method)
+            {
+                int counter = 1;
+                double position = 0.0;
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                for (int b = 0; b < numBlocks; ++b)
+                {
+                    auto onStep = [&] (int offset) { checksum[method] += (juce::int64) b * blockSize + offset; };
+
+                    if (method == 0)
+                        counter = advanceBySample (counter, samplesPerStep, blockSize, onStep);
+                    else
+                        position = advance (position, (double) samplesPerStep, blockSize, onStep);
+                }
+
+                seconds[method] = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+            }
+
+            // offsets bloque a bloque, con el contador arrancando en cualquier valor
+            for (int c = -2; c <= samplesPerStep + 1 && identical; c += 97)
+            {
+                steps[0].clear();
+                steps[1].clear();
+                const int after0 = advanceBySample (c, samplesPerStep, blockSize, [&] (int o) { steps[0].push_back (o); });
+                const double after1 = advance ((double) (c - 1), (double) samplesPerStep, blockSize, [&] (int o) { steps[1].push_back (o); });
+                identical = steps[0] == steps[1] && (double) (after0 - 1) == after1;
+            }
+
+            identical = identical && checksum[0] == checksum[1];
+
+            juce::String line;
+            line << "Arp step clock @ " << blockSize << " samples - per sample: "
+                 << seconds[0] * 1.0e9 / numBlocks << " ns/block, direct: "
+                 << seconds[1] * 1.0e9 / numBlocks << " ns/block"
+                 << (identical ? "" : "  TIMING MISMATCH");
+            juce::Logger::writeToLog (line);
+
+            passed = passed && identical;
+        }
+
+        return passed;
+    }
+}
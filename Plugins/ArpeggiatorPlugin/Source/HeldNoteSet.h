@@ -0,0 +1,151 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Notas sostenidas del arpegiador, ordenadas por altura y después por canal.
+//
+// Capacidad fija: un bit por nota y canal (128 x 16), más la velocity de cada una.
+// Agregar o quitar una nota es prender o apagar un bit, sin vector, sin sort y sin
+// memoria dinámica en el audio thread. El orden sale de recorrer los bits: la lista
+// ordenada (para indexar heldNotes[i] como antes) se reconstruye sólo cuando hace
+// falta, una vez después de cada cambio, aunque entren 100 notas en el mismo bloque.
+class HeldNoteSet
+{
+public:
+    static constexpr int numNotes    = 128;
+    static constexpr int numChannels = 16;
+    static constexpr int capacity    = numNotes * numChannels;
+
+    struct Note
+    {
+        int noteNumber = 0;
+        int velocity   = 0;
+        int channel    = 1;   // 1 .. 16, como juce::MidiMessage
+    };
+
+    HeldNoteSet() = default;
+
+    //==============================================================================
+    // Devuelve false si la nota ya estaba (no cambia su velocity) o está fuera de rango
+    bool add (int noteNumber, int channel, int velocity) noexcept
+    {
+        if (! isValid (noteNumber, channel))
+            return false;
+
+        const auto bit = (juce::uint16) (1u << (channel - 1));
+
+        if ((channelMask[noteNumber] & bit) != 0)
+            return false;
+
+        channelMask[noteNumber] |= bit;
+        pitchMask[noteNumber >> 6] |= (juce::uint64) 1 << (noteNumber & 63);
+        velocities[noteNumber][channel - 1] = (juce::uint8) juce::jlimit (0, 127, velocity);
+
+        ++count;
+        orderDirty = true;
+        return true;
+    }
+
+    // Devuelve false si la nota no estaba
+    bool remove (int noteNumber, int channel) noexcept
+    {
+        if (! contains (noteNumber, channel))
+            return false;
+
+        channelMask[noteNumber] &= (juce::uint16) ~(1u << (channel - 1));
+
+        if (channelMask[noteNumber] == 0)
+            pitchMask[noteNumber >> 6] &= ~((juce::uint64) 1 << (noteNumber & 63));
+
+        --count;
+        orderDirty = true;
+        return true;
+    }
+
+    bool contains (int noteNumber, int channel) const noexcept
+    {
+        return isValid (noteNumber, channel)
+            && (channelMask[noteNumber] & (1u << (channel - 1))) != 0;
+    }
+
+    void clear() noexcept
+    {
+        std::fill (std::begin (channelMask), std::end (channelMask), (juce::uint16) 0);
+        pitchMask[0] = pitchMask[1] = 0;
+        count = 0;
+        orderDirty = true;
+    }
+
+    bool empty() const noexcept     { return count == 0; }
+    int  size() const noexcept      { return count; }
+
+    //==============================================================================
+    // La nota número index en orden de altura (y de canal, si empatan)
+    Note operator[] (int index) const noexcept
+    {
+        jassert (juce::isPositiveAndBelow (index, count));
+        updateOrder();
+
+        const int key = ordered[index];
+        return { key >> 4, (int) velocities[key >> 4][key & 15], (key & 15) + 1 };
+    }
+
+    // Posición de la nota en ese orden, o -1 si no está
+    int indexOf (int noteNumber, int channel) const noexcept
+    {
+        if (! contains (noteNumber, channel))
+            return -1;
+
+        updateOrder();
+
+        const auto key = (juce::uint16) ((noteNumber << 4) | (channel - 1));
+        return (int) (std::lower_bound (ordered, ordered + count, key) - ordered);
+    }
+
+private:
+    juce::uint16 channelMask[numNotes] {};      // bit c = canal c + 1
+    juce::uint64 pitchMask[2] {};               // notas con algún canal prendido
+    juce::uint8  velocities[numNotes][numChannels] {};
+    int count = 0;
+
+    // Claves (nota << 4 | canal - 1) en orden: reconstruidas cuando cambian los bits
+    mutable juce::uint16 ordered[capacity] {};
+    mutable bool orderDirty = false;
+
+    static bool isValid (int noteNumber, int channel) noexcept
+    {
+        return juce::isPositiveAndBelow (noteNumber, numNotes)
+            && channel >= 1 && channel <= numChannels;
+    }
+
+    // Posición del bit más bajo: popcount de los bits por debajo
+    static int lowestBit (juce::uint64 bits) noexcept
+    {
+        return juce::countNumberOfBitsSet ((bits & (~bits + 1)) - 1);
+    }
+
+    void updateOrder() const noexcept
+    {
+        if (! orderDirty)
+            return;
+
+        int n = 0;
+
+        for (int word = 0; word < 2; ++word)
+        {
+            for (auto pitches = pitchMask[word]; pitches != 0; pitches &= pitches - 1)
+            {
+                const int note = word * 64 + lowestBit (pitches);
+
+                for (juce::uint32 channels = channelMask[note]; channels != 0; channels &= channels - 1)
+                    ordered[n++] = (juce::uint16) ((note << 4) | lowestBit (channels));
+            }
+        }
+
+        jassert (n == count);
+        orderDirty = false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HeldNoteSet)
+};
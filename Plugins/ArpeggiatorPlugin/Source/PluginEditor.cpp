@@ -7,9 +7,17 @@ ArpeggiatorPluginAudioProcessorEditor::ArpeggiatorPluginAudioProcessorEditor (Ar
 {
     using namespace juce;
 
-    setSize (340, 140);
+    setSize (340, 300);
 
     // Labels
+    channelModeLabel.setText ("Channels", dontSendNotification);
+    channelModeLabel.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (channelModeLabel);
+
+    laneLabel.setText ("Lane", dontSendNotification);
+    laneLabel.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (laneLabel);
+
     divisionLabel.setText ("Division", dontSendNotification);
     divisionLabel.setJustificationType (Justification::centredRight);
     addAndMakeVisible (divisionLabel);
@@ -18,10 +26,34 @@ ArpeggiatorPluginAudioProcessorEditor::ArpeggiatorPluginAudioProcessorEditor (Ar
     directionLabel.setJustificationType (Justification::centredRight);
     addAndMakeVisible (directionLabel);
 
+    patternLabel.setText ("Pattern", dontSendNotification);
+    patternLabel.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (patternLabel);
+
+    gateLabel.setText ("Gate", dontSendNotification);
+    gateLabel.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (gateLabel);
+
+    swingLabel.setText ("Swing", dontSendNotification);
+    swingLabel.setJustificationType (Justification::centredRight);
+    addAndMakeVisible (swingLabel);
+
     infoLabel.setText ("Host-synced arpeggiator", dontSendNotification);
     infoLabel.setJustificationType (Justification::centred);
     addAndMakeVisible (infoLabel);
 
+    // Channel mode ComboBox
+    channelModeBox.addItem ("Merged",      1);
+    channelModeBox.addItem ("Per channel", 2);
+    addAndMakeVisible (channelModeBox);
+
+    // Lane ComboBox: en modo Per channel, el carril n arpegia el canal MIDI n
+    for (int lane = 0; lane < ArpeggiatorPluginAudioProcessor::maxLanes; ++lane)
+        laneBox.addItem ("Channel " + String (lane + 1), lane + 1);
+
+    laneBox.onChange = [this] { attachLane (laneBox.getSelectedItemIndex()); };
+    addAndMakeVisible (laneBox);
+
     // Division ComboBox
     divisionBox.addItem ("1/4",  1);
     divisionBox.addItem ("1/8",  2);
@@ -36,13 +68,44 @@ ArpeggiatorPluginAudioProcessorEditor::ArpeggiatorPluginAudioProcessorEditor (Ar
     directionBox.addItem ("Random",  4);
     addAndMakeVisible (directionBox);
 
+    // Pattern ComboBox
+    patternBox.addItemList (ArpPattern::getPresetNames(), 1);
+    addAndMakeVisible (patternBox);
+
+    // Gate / Swing
+    for (auto* slider : { &gateSlider, &swingSlider })
+    {
+        slider->setSliderStyle (Slider::LinearHorizontal);
+        slider->setTextBoxStyle (Slider::TextBoxRight, false, 50, 20);
+        addAndMakeVisible (*slider);
+    }
+
     // Attachments (conectan UI <-> APVTS)
-    divisionAttachment  = std::make_unique<ComboBoxAttachment> (audioProcessor.apvts, "DIVISION",  divisionBox);
-    directionAttachment = std::make_unique<ComboBoxAttachment> (audioProcessor.apvts, "DIRECTION", directionBox);
+    channelModeAttachment = std::make_unique<ComboBoxAttachment> (audioProcessor.apvts, "CHANNEL_MODE", channelModeBox);
+    gateAttachment      = std::make_unique<SliderAttachment>   (audioProcessor.apvts, "GATE",      gateSlider);
+    swingAttachment     = std::make_unique<SliderAttachment>   (audioProcessor.apvts, "SWING",     swingSlider);
+
+    laneBox.setSelectedItemIndex (0, dontSendNotification);
+    attachLane (0);
 }
 
 ArpeggiatorPluginAudioProcessorEditor::~ArpeggiatorPluginAudioProcessorEditor() = default;
 
+//==============================================================================
+void ArpeggiatorPluginAudioProcessorEditor::attachLane (int lane)
+{
+    using Processor = ArpeggiatorPluginAudioProcessor;
+
+    // Primero soltar los attachments viejos: dos a la vez sobre el mismo ComboBox se pisan
+    divisionAttachment.reset();
+    directionAttachment.reset();
+    patternAttachment.reset();
+
+    divisionAttachment  = std::make_unique<ComboBoxAttachment> (audioProcessor.apvts, Processor::laneParameterID ("DIVISION",  lane), divisionBox);
+    directionAttachment = std::make_unique<ComboBoxAttachment> (audioProcessor.apvts, Processor::laneParameterID ("DIRECTION", lane), directionBox);
+    patternAttachment   = std::make_unique<ComboBoxAttachment> (audioProcessor.apvts, Processor::laneParameterID ("PATTERN",   lane), patternBox);
+}
+
 //==============================================================================
 void ArpeggiatorPluginAudioProcessorEditor::paint (juce::Graphics& g)
 {
@@ -76,6 +139,16 @@ void ArpeggiatorPluginAudioProcessorEditor::resized()
     auto leftCol  = area.removeFromLeft (labelWidth + 8);
     auto rightCol = area;
 
+    // Modo de canales
+    auto modeRow = rightCol.removeFromTop (rowHeight);
+    channelModeLabel.setBounds (leftCol.removeFromTop (rowHeight));
+    channelModeBox.setBounds   (modeRow.reduced (4, 2));
+
+    // Carril que se edita
+    auto laneRow = rightCol.removeFromTop (rowHeight);
+    laneLabel.setBounds (leftCol.removeFromTop (rowHeight));
+    laneBox.setBounds   (laneRow.reduced (4, 2));
+
     // División
     auto row1 = rightCol.removeFromTop (rowHeight);
     divisionLabel.setBounds (leftCol.removeFromTop (rowHeight));
@@ -85,4 +158,19 @@ void ArpeggiatorPluginAudioProcessorEditor::resized()
     auto row2 = rightCol.removeFromTop (rowHeight);
     directionLabel.setBounds (leftCol.removeFromTop (rowHeight));
     directionBox.setBounds   (row2.reduced (4, 2));
+
+    // Patrón
+    auto row3 = rightCol.removeFromTop (rowHeight);
+    patternLabel.setBounds (leftCol.removeFromTop (rowHeight));
+    patternBox.setBounds   (row3.reduced (4, 2));
+
+    // Gate
+    auto row4 = rightCol.removeFromTop (rowHeight);
+    gateLabel.setBounds  (leftCol.removeFromTop (rowHeight));
+    gateSlider.setBounds (row4.reduced (4, 2));
+
+    // Swing
+    auto row5 = rightCol.removeFromTop (rowHeight);
+    swingLabel.setBounds  (leftCol.removeFromTop (rowHeight));
+    swingSlider.setBounds (row5.reduced (4, 2));
 }
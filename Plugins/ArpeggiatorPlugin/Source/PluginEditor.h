@@ -18,17 +18,36 @@ public:
 private:
     ArpeggiatorPluginAudioProcessor& audioProcessor;
 
+    // Conecta división, dirección y patrón al carril elegido en laneBox
+    void attachLane (int lane);
+
     using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    using SliderAttachment   = juce::AudioProcessorValueTreeState::SliderAttachment;
 
+    juce::Label channelModeLabel;
+    juce::Label laneLabel;
     juce::Label divisionLabel;
     juce::Label directionLabel;
+    juce::Label patternLabel;
+    juce::Label gateLabel;
+    juce::Label swingLabel;
     juce::Label infoLabel;     // texto con info (tempo, etc.)
 
+    juce::ComboBox channelModeBox;
+    juce::ComboBox laneBox;        // qué carril se edita (no es un parámetro)
     juce::ComboBox divisionBox;
     juce::ComboBox directionBox;
+    juce::ComboBox patternBox;
+
+    juce::Slider gateSlider;
+    juce::Slider swingSlider;
 
+    std::unique_ptr<ComboBoxAttachment> channelModeAttachment;
     std::unique_ptr<ComboBoxAttachment> divisionAttachment;
     std::unique_ptr<ComboBoxAttachment> directionAttachment;
+    std::unique_ptr<ComboBoxAttachment> patternAttachment;
+    std::unique_ptr<SliderAttachment>   gateAttachment;
+    std::unique_ptr<SliderAttachment>   swingAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ArpeggiatorPluginAudioProcessorEditor)
 };
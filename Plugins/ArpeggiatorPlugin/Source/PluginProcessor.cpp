@@ -1,7 +1,9 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "ArpStepClock.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 //==============================================================================
@@ -24,12 +26,19 @@ ArpeggiatorPluginAudioProcessor::ArpeggiatorPluginAudioProcessor()
     // Defaults
     currentSampleRate    = 44100.0;
     bpm                  = 120.0;
-    division             = 16;     // semicorcheas
-    samplesPerStep       = 1;
-    samplesUntilNextStep = 1;
 
-    direction            = ArpDirection::Up;
-    goingUp              = true;
+    for (int lane = 0; lane < maxLanes; ++lane)
+    {
+        divisionParams[lane]  = apvts.getRawParameterValue (laneParameterID ("DIVISION",  lane));
+        directionParams[lane] = apvts.getRawParameterValue (laneParameterID ("DIRECTION", lane));
+        patternParams[lane]   = apvts.getRawParameterValue (laneParameterID ("PATTERN",   lane));
+    }
+
+    gateParam        = apvts.getRawParameterValue ("GATE");
+    swingParam       = apvts.getRawParameterValue ("SWING");
+    channelModeParam = apvts.getRawParameterValue ("CHANNEL_MODE");
+
+    resetLanes();
 }
 
 ArpeggiatorPluginAudioProcessor::~ArpeggiatorPluginAudioProcessor() = default;
@@ -43,22 +52,61 @@ ArpeggiatorPluginAudioProcessor::createParameterLayout()
     using namespace juce;
 
     params.push_back (std::make_unique<AudioParameterChoice> (
-        ParameterID { "DIVISION", 1 },
-        "Division",
-        StringArray { "1/4", "1/8", "1/16", "1/32" },
-        2   // default: "1/16"
+        ParameterID { "CHANNEL_MODE", 1 },
+        "Channels",
+        StringArray { "Merged", "Per channel" },
+        0   // default: un solo arpegio, como antes
     ));
 
-    params.push_back (std::make_unique<AudioParameterChoice> (
-        ParameterID { "DIRECTION", 1 },
-        "Direction",
-        StringArray { "Up", "Down", "UpDown", "Random" },
-        0   // default: Up
+    // División, dirección y patrón de cada carril (el carril 1 con los IDs de siempre)
+    for (int lane = 0; lane < maxLanes; ++lane)
+    {
+        const auto suffix = lane == 0 ? String() : " " + String (lane + 1);
+
+        params.push_back (std::make_unique<AudioParameterChoice> (
+            ParameterID { laneParameterID ("DIVISION", lane), 1 },
+            "Division" + suffix,
+            StringArray { "1/4", "1/8", "1/16", "1/32" },
+            2   // default: "1/16"
+        ));
+
+        params.push_back (std::make_unique<AudioParameterChoice> (
+            ParameterID { laneParameterID ("DIRECTION", lane), 1 },
+            "Direction" + suffix,
+            StringArray { "Up", "Down", "UpDown", "Random" },
+            0   // default: Up
+        ));
+
+        params.push_back (std::make_unique<AudioParameterChoice> (
+            ParameterID { laneParameterID ("PATTERN", lane), 1 },
+            "Pattern" + suffix,
+            ArpPattern::getPresetNames(),
+            0   // default: Straight
+        ));
+    }
+
+    params.push_back (std::make_unique<AudioParameterFloat> (
+        ParameterID { "GATE", 1 },
+        "Gate",
+        NormalisableRange<float> (0.05f, 1.0f, 0.01f),
+        1.0f   // default: legato, hasta el próximo paso
+    ));
+
+    params.push_back (std::make_unique<AudioParameterFloat> (
+        ParameterID { "SWING", 1 },
+        "Swing",
+        NormalisableRange<float> (0.0f, 0.5f, 0.01f),
+        0.0f
     ));
 
     return { params.begin(), params.end() };
 }
 
+juce::String ArpeggiatorPluginAudioProcessor::laneParameterID (const juce::String& name, int lane)
+{
+    return lane == 0 ? name : name + juce::String (lane + 1);
+}
+
 // Helpers estáticos para mapear índice -> valor real
 int ArpeggiatorPluginAudioProcessor::divisionFromIndex (int index)
 {
@@ -137,6 +185,28 @@ void ArpeggiatorPluginAudioProcessor::prepareToPlay (double sampleRate, int /*sa
     currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
     updateTimingFromHost(); // intenta leer BPM del host
     updateTimingFromBpm();  // recalcula muestras por paso
+
+    // Reservar el MIDI de salida acá, así addEvent no pide memoria en el audio thread.
+    // Cada evento ocupa timestamp (int32) + tamaño (uint16) + los bytes del mensaje
+    processedMidi.ensureSize ((size_t) maxMidiEventsPerBlock * (sizeof (juce::int32) + sizeof (juce::uint16) + 3));
+    processedMidi.clear();
+    reservedMidiBytes = processedMidi.data.getNumAllocated();
+
+    // El tiempo vuelve a cero: las notas que estaban sonando reciben su note-off al
+    // principio del próximo bloque, y los carriles arrancan sin nota actual
+    noteQueue.flushNoteOffs (0);
+    blockStartSample = 0;
+    hostGridLocked = false;
+
+    for (int lane = 0; lane < maxLanes; ++lane)
+    {
+        lanes.currentNoteIndex[lane] = -1;
+        lanes.currentNote[lane]      = -1;
+        lanes.currentVelocity[lane]  = 0;
+
+        lanes.nextStepPosition[lane] = 0.0;
+        lanes.stepCounter[lane]      = 0;
+    }
 }
 
 void ArpeggiatorPluginAudioProcessor::releaseResources()
@@ -171,15 +241,26 @@ bool ArpeggiatorPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout&
 // Helpers de timing
 void ArpeggiatorPluginAudioProcessor::updateTimingFromHost()
 {
+    hostIsPlaying = false;
+    hostHasPpq    = false;
+
     auto* playHead = getPlayHead();
     if (playHead == nullptr)
         return;
 
-    juce::AudioPlayHead::CurrentPositionInfo pos;
-    if (playHead->getCurrentPosition (pos))
+    if (const auto pos = playHead->getPosition())
     {
-        if (pos.bpm > 0.0)
-            bpm = pos.bpm;
+        if (const auto hostBpm = pos->getBpm())
+            if (*hostBpm > 0.0)
+                bpm = *hostBpm;
+
+        hostIsPlaying = pos->getIsPlaying();
+
+        if (const auto ppq = pos->getPpqPosition())
+        {
+            hostPpq    = *ppq;
+            hostHasPpq = true;
+        }
     }
 }
 
@@ -188,66 +269,193 @@ void ArpeggiatorPluginAudioProcessor::updateTimingFromBpm()
     if (currentSampleRate <= 0.0)
         return;
 
-    // Leer parámetros desde APVTS
-    if (auto* divParam = apvts.getRawParameterValue ("DIVISION"))
-        division = divisionFromIndex ((int) std::round (divParam->load()));
-    
-    if (auto* dirParam = apvts.getRawParameterValue ("DIRECTION"))
-        direction = directionFromIndex ((int) std::round (dirParam->load()));
+    // Cambio de modo: las notas sostenidas estaban repartidas de otra forma, empezamos de
+    // cero (lo que ya estaba sonando termina con su note-off programado)
+    const auto mode = (int) std::round (channelModeParam->load()) == 1 ? ChannelMode::PerChannel
+                                                                      : ChannelMode::Merged;
+    if (mode != channelMode)
+    {
+        channelMode = mode;
+        resetLanes();
+    }
+
+    // Gate y swing son de todos los carriles: si cambian se recompilan todos los patrones
+    const float gate  = gateParam->load();
+    const float swing = swingParam->load();
+    const bool gateOrSwingChanged = gate != compiledGate || swing != compiledSwing;
+
+    compiledGate  = gate;
+    compiledSwing = swing;
 
     // beat = negra: duración en segundos
-    const double beatDurationSec  = 60.0 / bpm;
-    // stepDuration = 1/division nota
-    // 4/4 = 1 (beat) | 4/16 = 0.25 de beat
-    const double stepDurationSec  = beatDurationSec * (4.0 / (double) division);
-    
-    // Convertir segundos a samples
-    samplesPerStep = (int) std::max (1.0, std::round (stepDurationSec * currentSampleRate));
-
-    //samplesUntilNextStep es un contador que se va decrementando en el rendering del audio
-    if (samplesUntilNextStep <= 0 || samplesUntilNextStep > samplesPerStep)
-        samplesUntilNextStep = samplesPerStep;
+    const double beatDurationSec = 60.0 / bpm;
+
+    for (int lane = 0; lane < getNumActiveLanes(); ++lane)
+    {
+        // Leer parámetros desde APVTS
+        lanes.division[lane]  = divisionFromIndex ((int) std::round (divisionParams[lane]->load()));
+        lanes.direction[lane] = directionFromIndex ((int) std::round (directionParams[lane]->load()));
+
+        // Compilar sólo cuando algo cambió: en cada paso el scheduler sólo indexa la tabla
+        const int pattern = (int) std::round (patternParams[lane]->load());
+
+        if (pattern != lanes.compiledPattern[lane] || gateOrSwingChanged)
+        {
+            lanes.patternTable[lane].compile (ArpPattern::getPreset (pattern), gate, swing);
+            lanes.compiledPattern[lane] = pattern;
+        }
+
+        // stepDuration = 1/division nota
+        // 4/4 = 1 (beat) | 4/16 = 0.25 de beat
+        const double stepDurationSec = beatDurationSec * (4.0 / (double) lanes.division[lane]);
+
+        // Convertir segundos a samples. Sin redondear: un paso entero redondeado se corre
+        // respecto de la grilla del host un poco en cada paso
+        auto& samplesPerStep = lanes.samplesPerStep[lane];
+        samplesPerStep = std::max (1.0, stepDurationSec * currentSampleRate);
+
+        // nextStepPosition es la posición exacta del próximo paso, relativa al bloque actual
+        auto& nextStepPosition = lanes.nextStepPosition[lane];
+        if (nextStepPosition <= -1.0 || nextStepPosition >= samplesPerStep)
+            nextStepPosition = samplesPerStep - 1.0;
+    }
+}
+
+// Con el transporte del host andando, los pasos salen de su posición en negras (PPQ):
+// el paso k cae en k * (4 / division) negras, así que la grilla queda enganchada al
+// compás del host y no acumula error por largo que sea el render. Deja en
+// nextStepPosition y stepCounter de cada carril la posición y el número de su primer
+// paso pendiente.
+void ArpeggiatorPluginAudioProcessor::lockToHostGrid (int numSamples, int numLanes)
+{
+    const double samplesPerQuarter = currentSampleRate * 60.0 / bpm;
+    const double hostSample        = hostPpq * samplesPerQuarter; // inicio del bloque
+
+    // Reproducción continua: seguimos con el paso siguiente al último que sonó, así un
+    // redondeo justo en el borde del bloque no repite ni saltea un paso. Si el host saltó
+    // (play, loop, locate) o cambió la división, buscamos el primer paso que todavía no
+    // sonó: el primero que redondea a una muestra de este bloque o posterior.
+    const bool transportContinuous = hostGridLocked
+                                  && std::abs (hostPpq - expectedHostPpq) * samplesPerQuarter < 1.0;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        const double samplesPerStep = lanes.samplesPerStep[lane];
+        const bool continuous = transportContinuous && lanes.division[lane] == lanes.hostGridDivision[lane];
+
+        const juce::int64 step = continuous ? lanes.lastHostStep[lane] + 1
+                                            : (juce::int64) std::ceil ((hostSample - 0.5) / samplesPerStep);
+
+        lanes.nextStepPosition[lane] = (double) step * samplesPerStep - hostSample;
+        lanes.stepCounter[lane]      = step; // el patrón arranca con el compás del host
+        lanes.hostGridDivision[lane] = lanes.division[lane];
+    }
+
+    hostGridLocked  = true;
+    expectedHostPpq = hostPpq + (double) numSamples / samplesPerQuarter;
 }
 
 //==============================================================================
-// Helpers de notas
-void ArpeggiatorPluginAudioProcessor::turnOffCurrentNote (juce::MidiBuffer& midiOut, int samplePos)
+// Carriles
+int ArpeggiatorPluginAudioProcessor::laneForChannel (int channel) const noexcept
+{
+    return channelMode == ChannelMode::PerChannel ? juce::jlimit (0, maxLanes - 1, channel - 1) : 0;
+}
+
+void ArpeggiatorPluginAudioProcessor::resetLanes()
 {
-    if (currentNote >= 0)
+    for (int lane = 0; lane < maxLanes; ++lane)
     {
-        auto off = juce::MidiMessage::noteOff (currentChannel, currentNote);
-        midiOut.addEvent (off, samplePos);
+        lanes.heldNotes[lane].clear();
+        lanes.heldNotesChanged[lane] = false;
 
-        currentNote      = -1;
-        currentVelocity  = 0;
+        lanes.currentNoteIndex[lane] = -1;
+        lanes.currentNote[lane]      = -1;
+        lanes.currentChannel[lane]   = lane + 1;
+        lanes.currentVelocity[lane]  = 0;
+
+        lanes.division[lane]  = 16;     // semicorcheas
+        lanes.direction[lane] = ArpDirection::Up;
+        lanes.goingUp[lane]   = true;
+
+        lanes.samplesPerStep[lane]   = 1.0;
+        lanes.nextStepPosition[lane] = 0.0;
+        lanes.stepCounter[lane]      = 0;
+
+        lanes.lastHostStep[lane]     = 0;
+        lanes.hostGridDivision[lane] = 0;   // la grilla del host se vuelve a buscar
+
+        lanes.compiledPattern[lane]  = -1;  // se compila en el próximo bloque
     }
 }
 
-void ArpeggiatorPluginAudioProcessor::noteOnReceived (int noteNumber, int velocity, int channel,
-                                                      juce::MidiBuffer& midiOut, int samplePos)
+// Un paso del carril lane, en la muestra offsetInBlock del bloque actual
+void ArpeggiatorPluginAudioProcessor::playStep (int lane, int offsetInBlock)
 {
-    // Evitar duplicados exactos
-    auto it = std::find_if (heldNotes.begin(), heldNotes.end(),
-                            [noteNumber, channel] (const HeldNote& n)
-                            {
-                                return n.noteNumber == noteNumber && n.channel == channel;
-                            });
-
-    if (it == heldNotes.end())
+    const auto step = lanes.stepCounter[lane]++;
+
+    // Sin notas sostenidas el paso pasa de largo (el contador se resetea igual)
+    if (lanes.heldNotes[lane].empty())
+        return;
+
+    const int nextIndex = getNextIndex (lane);
+
+    if (nextIndex >= 0)
     {
-        HeldNote n;
-        n.noteNumber = noteNumber;
-        n.velocity   = velocity;
-        n.channel    = channel;
-        heldNotes.push_back (n);
-
-        // Ordenar por altura cada vez que agregamos una nueva nota
-        sortHeldNotes();
+        const auto next = lanes.heldNotes[lane][nextIndex];
+
+        lanes.currentNote[lane]     = next.noteNumber;
+        lanes.currentChannel[lane]  = next.channel;
+        lanes.currentVelocity[lane] = next.velocity;
+
+        // Las notas del paso (y sus note-offs) van a la cola: pueden caer en otro bloque
+        scheduleStep (lane, step, blockStartSample + offsetInBlock, next);
     }
+}
+
+// Programa las notas del paso `step` de la grilla, que cae en la muestra absoluta stepTime
+void ArpeggiatorPluginAudioProcessor::scheduleStep (int lane, juce::int64 step, juce::int64 stepTime, const HeldNote& note)
+{
+    const auto entry = lanes.patternTable[lane].getStep (step);
+    const double samplesPerStep = lanes.samplesPerStep[lane];
+
+    // Probabilidad: el paso entero suena o no (el arpegio avanza igual)
+    if (entry.probability < 1.0f && rng.nextFloat() >= entry.probability)
+        return;
+
+    for (int e = 0; e < entry.numEvents; ++e)
+    {
+        const auto& event = entry.events[e];
+        const int noteNumber = note.noteNumber + 12 * event.octave;
+
+        if (! juce::isPositiveAndBelow (noteNumber, 128))
+            continue;
+
+        const auto onTime  = stepTime + (juce::int64) std::llround (event.offset * samplesPerStep);
+        const auto offTime = stepTime + (juce::int64) std::llround ((event.offset + event.length) * samplesPerStep);
+        const int velocity = juce::roundToInt ((float) note.velocity * event.velocity);
+
+        noteQueue.addNote (onTime, offTime, noteNumber, note.channel, velocity);
+    }
+}
+
+//==============================================================================
+// Helpers de notas
+
+void ArpeggiatorPluginAudioProcessor::noteOnReceived (int noteNumber, int velocity, int channel,
+                                                      juce::MidiBuffer& midiOut, int samplePos)
+{
+    const int lane = laneForChannel (channel);
+
+    // Evitar duplicados exactos: add() no hace nada si la nota ya estaba.
+    // El set queda ordenado por altura solo; el índice actual se recalcula en el próximo paso
+    if (lanes.heldNotes[lane].add (noteNumber, channel, velocity))
+        lanes.heldNotesChanged[lane] = true;
 
     // Si no hay nota actual sonando, disparar cuanto antes
-    if (currentNote < 0)
-        samplesUntilNextStep = 0;
+    // (siguiendo al host, en cambio, se espera al próximo paso de la grilla)
+    if (lanes.currentNote[lane] < 0)
+        lanes.nextStepPosition[lane] = -1.0;
 
     juce::ignoreUnused (midiOut, samplePos);
 }
@@ -255,73 +463,53 @@ void ArpeggiatorPluginAudioProcessor::noteOnReceived (int noteNumber, int veloci
 void ArpeggiatorPluginAudioProcessor::noteOffReceived (int noteNumber, int channel,
                                                        juce::MidiBuffer& midiOut, int samplePos)
 {
-    heldNotes.erase (std::remove_if (heldNotes.begin(), heldNotes.end(),
-                                     [noteNumber, channel] (const HeldNote& n)
-                                     {
-                                         return n.noteNumber == noteNumber && n.channel == channel;
-                                     }),
-                     heldNotes.end());
+    const int lane = laneForChannel (channel);
 
-    if (currentNote == noteNumber && currentChannel == channel)
-        turnOffCurrentNote (midiOut, samplePos);
+    if (lanes.heldNotes[lane].remove (noteNumber, channel))
+        lanes.heldNotesChanged[lane] = true;
 
-    if (heldNotes.empty())
-    {
-        currentNoteIndex = -1;
-    }
-    else
+    // La nota que está sonando termina con su gate (su note-off ya está programado)
+    if (lanes.currentNote[lane] == noteNumber && lanes.currentChannel[lane] == channel)
     {
-        // Reordenar y recalcular índice
-        sortHeldNotes();
+        lanes.currentNote[lane]     = -1;
+        lanes.currentVelocity[lane] = 0;
     }
+
+    juce::ignoreUnused (midiOut, samplePos);
 }
 
-void ArpeggiatorPluginAudioProcessor::sortHeldNotes()
+void ArpeggiatorPluginAudioProcessor::updateCurrentNoteIndex (int lane)
 {
-    // Ordenar por altura (noteNumber). Si hay empate, por canal.
-    std::sort (heldNotes.begin(), heldNotes.end(),
-               [] (const HeldNote& a, const HeldNote& b)
-               {
-                   if (a.noteNumber == b.noteNumber)
-                       return a.channel < b.channel;
-
-                   return a.noteNumber < b.noteNumber;
-               });
-
-    // Recalcular currentNoteIndex para que siga apuntando a la nota actual
-    if (currentNote < 0 || heldNotes.empty())
-    {
-        currentNoteIndex = -1;
-        return;
-    }
+    // Recalcular currentNoteIndex para que siga apuntando a la nota actual.
+    // Si la nota actual ya no está en el set (o no hay ninguna), reseteamos el índice
+    const int currentNote = lanes.currentNote[lane];
 
-    for (int i = 0; i < (int) heldNotes.size(); ++i)
-    {
-        const auto& n = heldNotes[(size_t) i];
-        if (n.noteNumber == currentNote && n.channel == currentChannel)
-        {
-            currentNoteIndex = i;
-            return;
-        }
-    }
-
-    // Si la nota actual ya no está en la lista, reseteamos el índice
-    currentNoteIndex = -1;
+    lanes.currentNoteIndex[lane] = currentNote < 0 ? -1
+                                                   : lanes.heldNotes[lane].indexOf (currentNote, lanes.currentChannel[lane]);
+    lanes.heldNotesChanged[lane] = false;
 }
 
 //==============================================================================
 // Selección de índice según dirección
-int ArpeggiatorPluginAudioProcessor::getNextIndex()
+int ArpeggiatorPluginAudioProcessor::getNextIndex (int lane)
 {
+    const auto& heldNotes = lanes.heldNotes[lane];
+
     if (heldNotes.empty())
         return -1;
 
-    const int size = (int) heldNotes.size();
+    // Una sola vez por paso, aunque hayan entrado muchas notas desde el anterior
+    if (lanes.heldNotesChanged[lane])
+        updateCurrentNoteIndex (lane);
+
+    const int size = heldNotes.size();
+    auto& currentNoteIndex = lanes.currentNoteIndex[lane];
+    auto& goingUp = lanes.goingUp[lane];
 
     if (currentNoteIndex < 0 || currentNoteIndex >= size)
         currentNoteIndex = 0;
 
-    switch (direction)
+    switch (lanes.direction[lane])
     {
         case ArpDirection::Up:
             currentNoteIndex = (currentNoteIndex + 1) % size;
@@ -378,12 +566,12 @@ void ArpeggiatorPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& bu
 
     const int numSamples = buffer.getNumSamples();
 
-    updateTimingFromHost(); // Actualiza BPM
-    updateTimingFromBpm(); // Actualiza samplesUntilNextStep
+    updateTimingFromHost(); // Actualiza BPM y transporte
+    updateTimingFromBpm(); // Actualiza samplesPerStep
 
-    juce::MidiBuffer processedMidi;
+    processedMidi.clear(); // conserva la memoria reservada
 
-    // 2) Procesar MIDI entrante: construir heldNotes y pasar mensajes no NOTE
+    // 2) Procesar MIDI entrante: construir las heldNotes de cada carril y pasar mensajes no NOTE
     for (const auto metadata : midiMessages)
     {
         const auto& msg     = metadata.getMessage();
@@ -414,48 +602,48 @@ void ArpeggiatorPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& bu
     // Limpiamos el buffer MIDI original para reconstruirlo
     midiMessages.clear();
 
-    // 3) Avanzar el "reloj" por muestra y disparar notas arpegiadas
-    for (int i = 0; i < numSamples; ++i)
-    {
-        samplesUntilNextStep -= 1;
-        
-        if (samplesUntilNextStep <= 0) // ¿Toca disparar un nuevo step?
-        {
-            if (! heldNotes.empty()) // Hay notas siendo tocadas para arpegiar?
-            {
-                const int nextIndex = getNextIndex();
+    // 3) Avanzar el "reloj" y disparar notas arpegiadas: ArpStepClock calcula en qué
+    //    muestras del bloque caen los pasos, sin recorrer el bloque muestra por muestra,
+    //    y recorre los pasos de todos los carriles juntos, en orden de tiempo.
+    //    Con el host en play la grilla sale de su PPQ; si no, el reloj corre libre.
+    const int numLanes = getNumActiveLanes();
+    const bool followHost = hostIsPlaying && hostHasPpq;
 
-                if (nextIndex >= 0)
-                {
-                    const auto& next = heldNotes[(size_t) nextIndex];
+    if (followHost)
+        lockToHostGrid (numSamples, numLanes);
+    else
+        hostGridLocked = false;
 
-                    // Apagar nota anterior (si hay)
-                    turnOffCurrentNote (processedMidi, i);
+    ArpStepClock::advanceLanes (lanes.nextStepPosition, lanes.samplesPerStep, numLanes, numSamples,
+                                [this] (int lane, int i) { playStep (lane, i); });
 
-                    // Disparar nueva nota
-                    currentNote     = next.noteNumber;
-                    currentChannel  = next.channel;
-                    currentVelocity = next.velocity;
+    if (followHost)
+        for (int lane = 0; lane < numLanes; ++lane)
+            lanes.lastHostStep[lane] = lanes.stepCounter[lane] - 1;
 
-                    auto on = juce::MidiMessage::noteOn (currentChannel,
-                                                         currentNote,
-                                                         (juce::uint8) currentVelocity);
-                    // Insertar el mensaje MIDI on en el buffer processedMidi para ejecutarse en la muestra i del bloque de audio actual:
-                    processedMidi.addEvent (on, i);
+    // 4) Sacar de la cola lo que cae en este bloque, en la muestra exacta
+    const auto blockEndSample = blockStartSample + numSamples;
 
-                    samplesUntilNextStep = samplesPerStep;
-                }
-            }
-            else
-            {
-                // Sin notas sostenidas, reseteamos el counter hasta el proximo step
-                samplesUntilNextStep = samplesPerStep;
-            }
-        }
-    }
+    noteQueue.popUntil (blockEndSample, [this] (const ArpNoteQueue::Event& e)
+    {
+        const int pos = (int) juce::jmax ((juce::int64) 0, e.time - blockStartSample);
+
+        if (e.velocity > 0)
+            processedMidi.addEvent (juce::MidiMessage::noteOn (e.channel, e.note, (juce::uint8) e.velocity), pos);
+        else
+            processedMidi.addEvent (juce::MidiMessage::noteOff (e.channel, e.note), pos);
+    });
+
+    blockStartSample = blockEndSample;
+
+    // La memoria de processedMidi cambió: addEvent pidió memoria en el audio thread.
+    // Subir setMaxMidiEventsPerBlock si se espera tanto MIDI por bloque
+    jassert (processedMidi.data.getNumAllocated() == reservedMidiBytes);
 
-    // 4) Devolvemos el MIDI procesado al host
-    midiMessages.swapWith (processedMidi);
+    // 5) Devolvemos el MIDI procesado copiándolo al buffer del host (ya vacío), así
+    //    processedMidi conserva siempre su memoria reservada. El del host solo crece si
+    //    un bloque trae más eventos que cualquiera de los que ya le pasó el host
+    midiMessages.addEvents (processedMidi, 0, -1, 0);
 }
 
 //==============================================================================
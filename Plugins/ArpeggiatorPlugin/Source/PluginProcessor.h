@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "HeldNoteSet.h"
+#include "ArpPattern.h"
+#include "ArpNoteQueue.h"
 
 //==============================================================================
 /**
@@ -18,6 +21,15 @@ public:
         Random
     };
 
+    // Cómo se reparten los canales MIDI de entrada entre los carriles
+    enum class ChannelMode
+    {
+        Merged,     // un solo arpegio con todas las notas (carril 1)
+        PerChannel  // canal n -> carril n, cada uno con su división, dirección y patrón
+    };
+
+    static constexpr int maxLanes = 16;
+
     using APVTS = juce::AudioProcessorValueTreeState;
 
     //==============================================================================
@@ -61,47 +73,107 @@ public:
     APVTS apvts;
     static APVTS::ParameterLayout createParameterLayout();
 
+    // ID del parámetro `name` del carril lane (0 .. 15): el carril 1 usa el nombre solo
+    // ("DIVISION"), los demás le agregan el número ("DIVISION2" .. "DIVISION16")
+    static juce::String laneParameterID (const juce::String& name, int lane);
+
+    // Máximo de eventos MIDI por bloque para el que se reserva memoria en prepareToPlay
+    // (llamar antes de prepareToPlay, desde el message thread)
+    static constexpr int defaultMaxMidiEventsPerBlock = 1024;
+    void setMaxMidiEventsPerBlock (int maxEvents)   { maxMidiEventsPerBlock = juce::jmax (1, maxEvents); }
+
     // Getters simples
-    double      getBpm() const noexcept             { return bpm; }
-    int         getDivisionValue() const noexcept   { return division; }
-    ArpDirection getDirection() const noexcept      { return direction; }
+    double      getBpm() const noexcept                         { return bpm; }
+    int         getDivisionValue (int lane = 0) const noexcept  { return lanes.division[lane]; }
+    ArpDirection getDirection (int lane = 0) const noexcept     { return lanes.direction[lane]; }
 
 private:
     //======================= Estructuras internas ================================
-    struct HeldNote
+    using HeldNote = HeldNoteSet::Note;
+
+    // Estado de los carriles, structure-of-arrays: cada campo tiene un valor por carril,
+    // así el scheduler recorre los relojes de todos los carriles juntos
+    struct Lanes
     {
-        int noteNumber = 0;
-        int velocity   = 0;
-        int channel    = 1;
-    };
+        HeldNoteSet heldNotes[maxLanes];            // ordenadas por altura, sin memoria dinámica
+        bool        heldNotesChanged[maxLanes];
+
+        int  currentNoteIndex[maxLanes];            // índice de heldNotes
+        int  currentNote[maxLanes];                 // nota actual sonando (-1 = ninguna)
+        int  currentChannel[maxLanes];
+        int  currentVelocity[maxLanes];
+
+        int          division[maxLanes];            // 4=negra, 8=corchea, 16=semicorchea, 32=fusa
+        ArpDirection direction[maxLanes];
+        bool         goingUp[maxLanes];             // para modo UpDown
 
-    std::vector<HeldNote> heldNotes;
+        double samplesPerStep[maxLanes];            // exacto, sin redondear
+        double nextStepPosition[maxLanes];          // muestra exacta del próximo paso, relativa al bloque
+        juce::int64 stepCounter[maxLanes];          // paso de la grilla (con el host, su número de paso)
 
-    int   currentNoteIndex   = -1; // índice de heldNotes
-    int   currentNote        = -1; // nota actual sonando (-1 = ninguna)
-    int   currentChannel     = 1;
-    int   currentVelocity    = 0;
+        // Grilla del host: último paso que sonó y con qué división
+        juce::int64 lastHostStep[maxLanes];
+        int         hostGridDivision[maxLanes];
+
+        // Patrón: tabla compilada cuando cambian PATTERN, GATE o SWING
+        ArpPatternTable patternTable[maxLanes];
+        int             compiledPattern[maxLanes];
+    };
+
+    Lanes       lanes;
+    ChannelMode channelMode = ChannelMode::Merged;
 
     // Timing
     double currentSampleRate   = 44100.0;
     double bpm                 = 120.0;   // valor por defecto
-    int    division            = 16;      // 4=negra, 8=corchea, 16=semicorchea, 32=fusa
 
-    int    samplesPerStep       = 1;
-    int    samplesUntilNextStep = 1;
+    // Transporte del host (getPosition)
+    bool   hostIsPlaying        = false;
+    bool   hostHasPpq           = false;
+    double hostPpq              = 0.0;    // posición al inicio del bloque, en negras
+
+    // Grilla del host: dónde debería empezar el bloque siguiente si el transporte sigue
+    bool        hostGridLocked  = false;
+    double      expectedHostPpq = 0.0;
 
-    ArpDirection direction      = ArpDirection::Up;
-    bool         goingUp        = true;   // para modo UpDown
     juce::Random rng;
 
+    float compiledGate  = -1.0f;
+    float compiledSwing = -1.0f;
+
+    // Parámetros, buscados una vez en el constructor (no por nombre en cada bloque)
+    std::atomic<float>* divisionParams[maxLanes] {};
+    std::atomic<float>* directionParams[maxLanes] {};
+    std::atomic<float>* patternParams[maxLanes] {};
+    std::atomic<float>* gateParam = nullptr;
+    std::atomic<float>* swingParam = nullptr;
+    std::atomic<float>* channelModeParam = nullptr;
+
+    // Notas programadas (note-ons con swing/ratchets y note-offs del gate), en muestras
+    // absolutas desde prepareToPlay
+    ArpNoteQueue noteQueue;
+    juce::int64  blockStartSample = 0;
+
+    // MIDI de salida: reservado en prepareToPlay y reusado en cada bloque (clear / addEvents
+    // al buffer del host). reservedMidiBytes es la capacidad reservada, para detectar si creció
+    juce::MidiBuffer processedMidi;
+    int              maxMidiEventsPerBlock = defaultMaxMidiEventsPerBlock;
+    int              reservedMidiBytes = 0;
+
     //======================= Helpers de arpegiador ==============================
     void updateTimingFromHost();
     void updateTimingFromBpm();
+    void lockToHostGrid (int numSamples, int numLanes);
+
+    int  getNumActiveLanes() const noexcept     { return channelMode == ChannelMode::PerChannel ? maxLanes : 1; }
+    int  laneForChannel (int channel) const noexcept;
+    void resetLanes();
 
-    int  getNextIndex();
-    void sortHeldNotes();
+    int  getNextIndex (int lane);
+    void updateCurrentNoteIndex (int lane);
 
-    void turnOffCurrentNote (juce::MidiBuffer& midiOut, int samplePos);
+    void playStep (int lane, int offsetInBlock);
+    void scheduleStep (int lane, juce::int64 step, juce::int64 stepTime, const HeldNote& note);
     void noteOnReceived  (int noteNumber, int velocity, int channel,
                           juce::MidiBuffer& midiOut, int samplePos);
     void noteOffReceived (int noteNumber, int channel,
@@ -80,8 +80,6 @@ juce::AudioProcessorValueTreeState::ParameterLayout SynthPluginProcessor::create
 //==============================================================================
 void SynthPluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    juce::ignoreUnused (samplesPerBlock);
-
     spec.sampleRate       = sampleRate;
     spec.maximumBlockSize = (juce::uint32) samplesPerBlock;
     spec.numChannels      = (juce::uint32) getTotalNumOutputChannels();
@@ -100,6 +98,15 @@ void SynthPluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock
     adsr.setSampleRate (sampleRate);
     adsr.reset();
 
+    // Buffers de trabajo: acá y no en processBlock, para no pedir memoria en el audio thread.
+    // Cada evento MIDI ocupa timestamp (int32) + tamaño (uint16) + los bytes del mensaje
+    keyboardMidi.ensureSize ((size_t) maxMidiEventsPerBlock * (sizeof (juce::int32) + sizeof (juce::uint16) + 3));
+    keyboardMidi.clear();
+    reservedMidiBytes = keyboardMidi.data.getNumAllocated();
+
+    monoDataSize = juce::jmax (1, samplesPerBlock);
+    monoData.allocate ((size_t) monoDataSize, true);
+
     // Valores iniciales desde APVTS
     auto* waveParam   = apvts.getRawParameterValue ("WAVEFORM");
     auto* attackParam = apvts.getRawParameterValue ("ATTACK");
@@ -173,10 +180,18 @@ void SynthPluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
 
     setFilter (cutoffParam->load(), resoParam->load());
 
-    // --- MIDI (igual que antes) ---
-    keyboardState.processNextMidiBuffer (midiMessages, 0, numSamples, true);
+    // --- MIDI ---
+    // Las notas del teclado virtual se suman a una copia en keyboardMidi (memoria reservada)
+    // en vez de al buffer del host, que podría crecer en el audio thread
+    keyboardMidi.clear();
+    keyboardMidi.addEvents (midiMessages, 0, numSamples, 0);
+    keyboardState.processNextMidiBuffer (keyboardMidi, 0, numSamples, true);
 
-    for (const auto metadata : midiMessages)
+    // La memoria de keyboardMidi cambió: el buffer creció en el audio thread.
+    // Subir setMaxMidiEventsPerBlock si se espera tanto MIDI por bloque
+    jassert (keyboardMidi.data.getNumAllocated() == reservedMidiBytes);
+
+    for (const auto metadata : keyboardMidi)
     {
         const auto msg = metadata.getMessage();
 
@@ -192,8 +207,12 @@ void SynthPluginProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce:
     juce::dsp::AudioBlock<float> audioBlock (buffer);
     auto sub = audioBlock;
 
-    juce::HeapBlock<float> monoData;
-    monoData.allocate ((size_t) numSamples, true);
+    if (numSamples > monoDataSize)
+    {
+        jassertfalse; // el host mandó un bloque más grande que el de prepareToPlay
+        monoDataSize = numSamples;
+        monoData.allocate ((size_t) monoDataSize, true);
+    }
 
     float* monoChans[] = { monoData.get() };
     juce::dsp::AudioBlock<float> monoBlock (monoChans, (size_t) 1, (size_t) numSamples);
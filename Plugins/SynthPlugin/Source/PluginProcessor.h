@@ -57,6 +57,11 @@ public:
 
     juce::AudioProcessorValueTreeState apvts;
 
+    // Máximo de eventos MIDI por bloque para el que se reserva memoria en prepareToPlay
+    // (llamar antes de prepareToPlay, desde el message thread)
+    static constexpr int defaultMaxMidiEventsPerBlock = 1024;
+    void setMaxMidiEventsPerBlock (int maxEvents)            { maxMidiEventsPerBlock = juce::jmax (1, maxEvents); }
+
     // Métodos internos (ya existentes)
     void setWaveform (int index); // 0: sine, 1: saw, 2: square
     void setAdsr (float attack, float decay, float sustain, float release);
@@ -74,6 +79,13 @@ private:
     juce::dsp::ProcessSpec spec {};
     juce::SmoothedValue<float> velocityGain;
 
+    // Buffers de trabajo, reservados en prepareToPlay: processBlock no pide memoria
+    juce::MidiBuffer keyboardMidi;          // MIDI del host + teclado virtual
+    int maxMidiEventsPerBlock = defaultMaxMidiEventsPerBlock;
+    int reservedMidiBytes = 0;              // capacidad de keyboardMidi tras reservar
+    juce::HeapBlock<float> monoData;
+    int monoDataSize = 0;
+
     // Estado
     std::atomic<float> targetFrequencyHz { 440.0f };
     std::atomic<int>   currentWaveform   { 0 };      // 0: Sine, 1: Saw, 2: Square
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// MIDI throughput of a plugin's processBlock: an instance of the plugin is fed synthetic
+// MIDI streams (sparse playing, dense playing, note floods, CC floods) at block sizes
+// from 32 to 2048 samples. Each run reports input events per second, ns per block and
+// how many heap allocations processBlock made, so regressions show up as soon as
+// something allocates or slows down on the audio thread.
+//
+// Run by the Benchmarks console app, which loads the Release builds of the plugins.
+//
+// Allocation counting needs a hook in the allocator, and only the benchmark executable
+// installs one (Benchmarks/Source/AllocationHooks.cpp, Linux only for now). It counts
+// every malloc, calloc and realloc of the thread calling processBlock: operator new as
+// well as JUCE's HeapBlock, Array and MidiBuffer growth. Without a hook the count is
+// reported as "n/a".
+namespace MidiThroughputBenchmark
+{
+    //==============================================================================
+    // Counts the allocations made on the calling thread while a Scope is alive
+    struct AllocationCounter
+    {
+        static bool& isCounting() noexcept             { static thread_local bool counting = false; return counting; }
+        static juce::int64& getCount() noexcept        { static thread_local juce::int64 count = 0; return count; }
+
+        // Called by the allocator hook
+        static void allocationMade() noexcept
+        {
+            if (isCounting())
+                ++getCount();
+        }
+
+        // Set by the hook at start-up
+        static std::atomic<bool>& isAvailable() noexcept { static std::atomic<bool> available { false }; return available; }
+
+        struct Scope
+        {
+            Scope() noexcept
+            {
+                getCount() = 0;
+                isCounting() = true;
+            }
+
+            ~Scope()
+            {
+                isCounting() = false;
+            }
+
+            juce::int64 getAllocations() const noexcept     { return getCount(); }
+        };
+    };
+
+    //==============================================================================
+    enum class Stream
+    {
+        Sparse,             // a note every quarter second
+        Dense,              // 4-note chords 32 times a second, plus a mod wheel sweep
+        NoteFlood,          // 128 notes on and off in every block, on all 16 channels
+        ControllerFlood     // 512 CCs in every block
+    };
+
+    inline const char* getName (Stream stream)
+    {
+        switch (stream)
+        {
+            case Stream::Sparse:            return "sparse";
+            case Stream::Dense:             return "dense";
+            case Stream::NoteFlood:         return "note flood";
+            case Stream::ControllerFlood:   return "CC flood";
+            default:                        return "?";
+        }
+    }
+
+    // Calls fn (n, position) for every event n of a grid of `period` samples (offset by
+    // `phase`) that falls in the block [blockStart, blockStart + blockSize)
+    template <typename Function>
+    inline void forEachOnGrid (juce::int64 blockStart, int blockSize, juce::int64 period, juce::int64 phase, Function&& fn)
+    {
+        auto n = (blockStart - phase + period - 1) / period;
+        n = juce::jmax ((juce::int64) 0, n);
+
+        for (auto t = n * period + phase; t < blockStart + blockSize; t += period, ++n)
+            fn (n, (int) (t - blockStart));
+    }
+
+    // Replaces the contents of midi with the events of `stream` in the block that starts
+    // at sample blockStart. Events are time-based (the same stream at any block size),
+    // except the floods, which are per block.
+    inline void fillBlock (juce::MidiBuffer& midi, Stream stream, juce::int64 blockStart, int blockSize)
+    {
+        midi.clear();
+
+        switch (stream)
+        {
+            case Stream::Sparse:
+                forEachOnGrid (blockStart, blockSize, 12000, 0,    [&] (juce::int64 n, int pos) { midi.addEvent (juce::MidiMessage::noteOn  (1, 48 + (int) (n % 24), (juce::uint8) 100), pos); });
+                forEachOnGrid (blockStart, blockSize, 12000, 6000, [&] (juce::int64 n, int pos) { midi.addEvent (juce::MidiMessage::noteOff (1, 48 + (int) (n % 24)), pos); });
+                break;
+
+            case Stream::Dense:
+                forEachOnGrid (blockStart, blockSize, 1500, 0, [&] (juce::int64 n, int pos)
+                {
+                    for (int k = 0; k < 4; ++k)
+                        midi.addEvent (juce::MidiMessage::noteOn (1, 48 + (int) (n % 12) + 4 * k, (juce::uint8) (64 + 15 * k)), pos);
+                });
+                forEachOnGrid (blockStart, blockSize, 1500, 750, [&] (juce::int64 n, int pos)
+                {
+                    for (int k = 0; k < 4; ++k)
+                        midi.addEvent (juce::MidiMessage::noteOff (1, 48 + (int) (n % 12) + 4 * k), pos);
+                });
+                forEachOnGrid (blockStart, blockSize, 96, 48, [&] (juce::int64 n, int pos)
+                {
+                    midi.addEvent (juce::MidiMessage::controllerEvent (1, 1, (int) (n % 128)), pos);
+                });
+                break;
+
+            case Stream::NoteFlood:
+                for (int i = 0; i < 128; ++i)
+                    midi.addEvent (juce::MidiMessage::noteOn (1 + (i & 15), i, (juce::uint8) (1 + i % 127)), (i * blockSize) / 256);
+
+                for (int i = 0; i < 128; ++i)
+                    midi.addEvent (juce::MidiMessage::noteOff (1 + (i & 15), i), ((128 + i) * blockSize) / 256);
+                break;
+
+            case Stream::ControllerFlood:
+                for (int i = 0; i < 512; ++i)
+                    midi.addEvent (juce::MidiMessage::controllerEvent (1, 1 + (i & 7), i & 127), (i * blockSize) / 512);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    //==============================================================================
+    struct Figures
+    {
+        double eventsPerSecond = 0.0;   // input events through processBlock per second of CPU
+        double nsPerBlock = 0.0;
+        juce::int64 warmUpAllocations = 0;  // inside processBlock, first second
+        juce::int64 allocations = 0;        // inside processBlock, after the first second
+        int numBlocks = 0;
+    };
+
+    // Plays `seconds` of `stream` through processor at 48 kHz, like a host would: the
+    // audio and MIDI buffers are created once and reused for every block, and the MIDI
+    // buffer is not reserved, so it only has the capacity the events so far gave it.
+    // Only the processBlock calls are timed and counted.
+    inline Figures measure (juce::AudioProcessor& processor, Stream stream, int blockSize, double seconds = 10.0)
+    {
+        constexpr double sampleRate = 48000.0;
+
+        const int numBlocks = juce::jmax (1, (int) (seconds * sampleRate / blockSize));
+        const int numWarmUpBlocks = juce::jmin (numBlocks, (int) (sampleRate / blockSize));
+        const int numChannels = juce::jmax (1, processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+
+        juce::AudioBuffer<float> audio (numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        Figures figures;
+        juce::int64 ticks = 0, events = 0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            fillBlock (midi, stream, (juce::int64) b * blockSize, blockSize);
+            events += midi.getNumEvents();
+            audio.clear();
+
+            const AllocationCounter::Scope allocationScope;
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            processor.processBlock (audio, midi);
+
+            ticks += juce::Time::getHighResolutionTicks() - start;
+            (b < numWarmUpBlocks ? figures.warmUpAllocations : figures.allocations) += allocationScope.getAllocations();
+        }
+
+        processor.releaseResources();
+
+        const auto elapsed = juce::Time::highResolutionTicksToSeconds (ticks);
+
+        figures.eventsPerSecond = elapsed > 0.0 ? (double) events / elapsed : 0.0;
+        figures.nsPerBlock = elapsed * 1.0e9 / (double) numBlocks;
+        figures.numBlocks = numBlocks;
+        return figures;
+    }
+
+    // Every stream at block sizes 32 .. 2048. Returns false if processBlock allocated
+    // after the first second of any run (while the host's MIDI buffer may still be growing,
+    // allocations are reported but allowed).
+    inline bool logAll (juce::AudioProcessor& processor, const juce::String& name)
+    {
+        const bool counted = AllocationCounter::isAvailable().load();
+        bool passed = true;
+
+        for (auto stream : { Stream::Sparse, Stream::Dense, Stream::NoteFlood, Stream::ControllerFlood })
+        {
+            for (int blockSize = 32; blockSize <= 2048; blockSize *= 2)
+            {
+                const auto f = measure (processor, stream, blockSize);
+
+                juce::String line;
+                line << name << " MIDI " << getName (stream) << " @ " << blockSize << " samples: "
+                     << f.eventsPerSecond / 1.0e6 << " M events/s, " << f.nsPerBlock << " ns/block, allocations: "
+                     << (counted ? juce::String (f.warmUpAllocations) + " in the first second, "
+                                     + juce::String (f.allocations) + " after (" + juce::String (f.numBlocks) + " blocks)"
+                                 : juce::String ("n/a"));
+                juce::Logger::writeToLog (line);
+
+                passed = passed && f.allocations == 0; // something in processBlock is allocating
+            }
+        }
+
+        return passed;
+    }
+}
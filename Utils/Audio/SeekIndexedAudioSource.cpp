@@ -0,0 +1,354 @@
+#include "SeekIndexedAudioSource.h"
+
+//==============================================================================
+// One background thread shared by every SeekIndexedAudioSource in the app
+struct SeekIndexThreadPool : public juce::ThreadPool
+{
+    SeekIndexThreadPool() : juce::ThreadPool (1) {}
+};
+
+//==============================================================================
+// Index files used by live sources in this process. Two sources of the same file share
+// one index, so it is only deleted when the last of them goes (and never if one of them
+// asked to keep it), and trimIndexCache() leaves it alone while it is mapped.
+struct SeekIndexUsers
+{
+    struct Use { int numUsers = 0; bool persist = false; };
+
+    juce::CriticalSection lock;
+    std::map<juce::String, Use> uses;
+
+    static SeekIndexUsers& get()
+    {
+        static SeekIndexUsers users;
+        return users;
+    }
+
+    void acquire (const juce::File& indexFile, bool persist)
+    {
+        const juce::ScopedLock sl (lock);
+        auto& use = uses[indexFile.getFullPathName()];
+        ++use.numUsers;
+        use.persist = use.persist || persist;
+    }
+
+    // Returns true if this was the last user and nobody asked to keep the index
+    bool release (const juce::File& indexFile)
+    {
+        const juce::ScopedLock sl (lock);
+        auto it = uses.find (indexFile.getFullPathName());
+
+        if (it == uses.end() || --it->second.numUsers > 0)
+            return false;
+
+        const bool shouldDelete = ! it->second.persist;
+        uses.erase (it);
+        return shouldDelete;
+    }
+
+    bool isInUse (const juce::File& indexFile)
+    {
+        const juce::ScopedLock sl (lock);
+        return uses.find (indexFile.getFullPathName()) != uses.end();
+    }
+};
+
+//==============================================================================
+// Decodes the compressed file once into a PCM index file. It is written under a unique
+// temporary name and renamed into place, so a half-written index is never picked up and
+// an index another source has mapped is never overwritten.
+class SeekIndexedAudioSource::IndexBuildJob : public juce::ThreadPoolJob
+{
+public:
+    explicit IndexBuildJob (SeekIndexedAudioSource& ownerToNotify)
+        : juce::ThreadPoolJob ("Seek index: " + ownerToNotify.sourceFile.getFileName()),
+          owner (ownerToNotify)
+    {
+    }
+
+    // Called by the owner before it waits for the job: the decode loop stops at the next block
+    void cancel() noexcept                  { cancelled.store (true); }
+
+    JobStatus runJob() override
+    {
+        // Jobs run one at a time: another source of the same file may have built it meanwhile
+        if (! owner.indexFile.existsAsFile() && ! buildIndexFile())
+            return jobHasFinished;
+
+        if (isCancelled())
+            return jobHasFinished;
+
+        SeekIndexedAudioSource::trimIndexCache();
+
+        if (! isCancelled() && owner.openIndex())
+            owner.indexReady.store (true);
+
+        return jobHasFinished;
+    }
+
+private:
+    SeekIndexedAudioSource& owner;
+    std::atomic<bool> cancelled { false };
+
+    bool isCancelled() const noexcept       { return cancelled.load() || shouldExit(); }
+
+    bool buildIndexFile()
+    {
+        // A separate reader: the playing one belongs to the audio/read-ahead thread
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (owner.sourceFile));
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+            return false;
+
+        owner.indexFile.getParentDirectory().createDirectory();
+        juce::TemporaryFile tempFile (owner.indexFile); // unique name beside the index, deleted if unused
+
+        {
+            std::unique_ptr<juce::FileOutputStream> out (tempFile.getFile().createOutputStream());
+            if (out == nullptr)
+                return false;
+
+            juce::WavAudioFormat wavFormat;
+            std::unique_ptr<juce::AudioFormatWriter> writer (wavFormat.createWriterFor (out.get(), reader->sampleRate,
+                                                                                         reader->numChannels,
+                                                                                         getIndexBitDepth (*reader), {}, 0));
+            if (writer == nullptr)
+                return false;
+
+            out.release(); // now owned by the writer
+
+            constexpr int blockSize = 65536;
+            juce::AudioBuffer<float> block ((int) reader->numChannels, blockSize);
+
+            for (juce::int64 pos = 0; pos < reader->lengthInSamples; pos += blockSize)
+            {
+                if (isCancelled())
+                    return false;
+
+                const int num = (int) juce::jmin ((juce::int64) blockSize, reader->lengthInSamples - pos);
+
+                if (! reader->read (&block, 0, num, pos, true, true)
+                     || ! writer->writeFromAudioSampleBuffer (block, 0, num))
+                    return false;
+            }
+        }
+
+        // a plain rename while the target doesn't exist; if it appeared meanwhile, keep it
+        return owner.indexFile.existsAsFile() || tempFile.getFile().moveFileTo (owner.indexFile);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IndexBuildJob)
+};
+
+//==============================================================================
+SeekIndexedAudioSource::SeekIndexedAudioSource (juce::AudioFormatReader* reader, const juce::File& file,
+                                                bool shouldPersistIndex)
+    : compressedSource (reader, true),
+      sourceFile (file),
+      persistIndex (shouldPersistIndex)
+{
+    if (sourceFile == juce::File() || ! needsSeekIndex (sourceFile))
+        return;
+
+    indexFile = getIndexFileFor (sourceFile, *reader);
+    SeekIndexUsers::get().acquire (indexFile, persistIndex);
+
+    // Reuse an index built in a previous session: mapping it is cheap, so do it right away
+    if (indexFile.existsAsFile() && openIndex())
+    {
+        indexFile.setLastModificationTime (juce::Time::getCurrentTime()); // most recently used
+        indexReady.store (true);
+        return;
+    }
+
+    buildJob = std::make_unique<IndexBuildJob> (*this);
+    juce::SharedResourcePointer<SeekIndexThreadPool>()->addJob (buildJob.get(), false);
+}
+
+SeekIndexedAudioSource::~SeekIndexedAudioSource()
+{
+    // The job reads sourceFile/indexFile and opens the index into this object, so it must
+    // be gone before anything is destroyed: no timeout, the decode loop checks the flag
+    // once per block.
+    if (buildJob != nullptr)
+    {
+        buildJob->cancel();
+        juce::SharedResourcePointer<SeekIndexThreadPool>()->removeJob (buildJob.get(), true, -1);
+    }
+
+    indexedSource.reset();
+    indexReader.reset();
+
+    if (indexFile != juce::File() && SeekIndexUsers::get().release (indexFile))
+        indexFile.deleteFile();
+}
+
+bool SeekIndexedAudioSource::needsSeekIndex (const juce::File& file)
+{
+    return file.hasFileExtension ("mp3;ogg;m4a;aac;wma");
+}
+
+int SeekIndexedAudioSource::getIndexBitDepth (const juce::AudioFormatReader& reader)
+{
+    // 32 is float in WAV: decoders that produce float (mp3, ogg...) are stored as they decode
+    if (reader.usesFloatingPointData || reader.bitsPerSample > 24)
+        return 32;
+
+    return reader.bitsPerSample <= 16 ? 16 : 24;
+}
+
+juce::File SeekIndexedAudioSource::getIndexFileFor (const juce::File& file, const juce::AudioFormatReader& reader)
+{
+    const auto key = file.getFullPathName()
+                   + juce::String (file.getSize())
+                   + juce::String (file.getLastModificationTime().toMilliseconds())
+                   + juce::String (getIndexBitDepth (reader));
+
+    return juce::File::getSpecialLocation (juce::File::tempDirectory)
+               .getChildFile ("PAS-SeekIndex")
+               .getChildFile (file.getFileNameWithoutExtension() + "_"
+                              + juce::String::toHexString (key.hashCode64()) + ".wav");
+}
+
+void SeekIndexedAudioSource::trimIndexCache()
+{
+    auto indices = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                       .getChildFile ("PAS-SeekIndex")
+                       .findChildFiles (juce::File::findFiles, false, "*.wav");
+
+    // newest first: reused indices are touched when they are opened
+    std::sort (indices.begin(), indices.end(), [] (const juce::File& a, const juce::File& b)
+    {
+        return a.getLastModificationTime() > b.getLastModificationTime();
+    });
+
+    juce::int64 total = 0;
+
+    for (int i = 0; i < indices.size(); ++i)
+    {
+        total += indices.getReference (i).getSize();
+
+        // indices mapped by a live source stay (they still count towards the total)
+        if (i > 0 && total > maxIndexCacheBytes && ! SeekIndexUsers::get().isInUse (indices.getReference (i)))
+            indices.getReference (i).deleteFile();
+    }
+}
+
+bool SeekIndexedAudioSource::openIndex()
+{
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (wavFormat.createMemoryMappedReader (indexFile));
+
+    if (mapped == nullptr || ! mapped->mapEntireFile())
+        return false;
+
+    // a stale or truncated index must never replace the real file
+    const auto& source = *compressedSource.getAudioFormatReader();
+
+    if (mapped->lengthInSamples != compressedSource.getTotalLength()
+         || mapped->numChannels != source.numChannels
+         || (int) mapped->bitsPerSample != getIndexBitDepth (source))
+        return false;
+
+    // Seek latency check: random seeks followed by one block read
+    {
+        juce::AudioBuffer<float> block ((int) mapped->numChannels, 512);
+        juce::Random rng;
+        double worstMs = 0.0;
+
+        for (int i = 0; i < 32; ++i)
+        {
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            const auto pos = (juce::int64) (rng.nextDouble() * (double) juce::jmax ((juce::int64) 0, mapped->lengthInSamples - 512));
+            mapped->read (&block, 0, 512, pos, true, true);
+            worstMs = juce::jmax (worstMs, juce::Time::getMillisecondCounterHiRes() - start);
+        }
+
+        indexSeekLatencyMs.store (worstMs);
+        DBG ("Seek index ready for " << sourceFile.getFileName() << ": worst random seek " << worstMs << " ms");
+    }
+
+    indexedSource = std::make_unique<juce::AudioFormatReaderSource> (mapped.get(), false);
+    indexReader = std::move (mapped);
+    return true;
+}
+
+//==============================================================================
+juce::PositionableAudioSource& SeekIndexedAudioSource::getActiveSource() noexcept
+{
+    if (indexActive.load())
+        return *indexedSource;
+
+    return compressedSource;
+}
+
+const juce::PositionableAudioSource& SeekIndexedAudioSource::getActiveSource() const noexcept
+{
+    if (indexActive.load())
+        return *indexedSource;
+
+    return compressedSource;
+}
+
+void SeekIndexedAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    compressedSource.prepareToPlay (samplesPerBlockExpected, sampleRate);
+}
+
+void SeekIndexedAudioSource::releaseResources()
+{
+    compressedSource.releaseResources();
+}
+
+void SeekIndexedAudioSource::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    // Switch over on the reading thread, at exactly the sample the compressed reader reached
+    if (! indexActive.load() && indexReady.load())
+    {
+        indexedSource->setLooping (compressedSource.isLooping());
+        indexedSource->setNextReadPosition (compressedSource.getNextReadPosition());
+        indexActive.store (true);
+    }
+
+    getActiveSource().getNextAudioBlock (bufferToFill);
+}
+
+void SeekIndexedAudioSource::setNextReadPosition (juce::int64 newPosition)
+{
+    if (indexReady.load())
+    {
+        // Constant time: pre-fault the target page so the next read doesn't stall
+        indexedSource->setNextReadPosition (newPosition);
+        indexReader->touchSample (juce::jlimit ((juce::int64) 0, juce::jmax ((juce::int64) 0, indexReader->lengthInSamples - 1), newPosition));
+
+        if (indexActive.load())
+            return;
+    }
+
+    compressedSource.setNextReadPosition (newPosition);
+}
+
+juce::int64 SeekIndexedAudioSource::getNextReadPosition() const
+{
+    return getActiveSource().getNextReadPosition();
+}
+
+juce::int64 SeekIndexedAudioSource::getTotalLength() const
+{
+    return compressedSource.getTotalLength();
+}
+
+bool SeekIndexedAudioSource::isLooping() const
+{
+    return compressedSource.isLooping();
+}
+
+void SeekIndexedAudioSource::setLooping (bool shouldLoop)
+{
+    compressedSource.setLooping (shouldLoop);
+
+    if (indexReady.load())
+        indexedSource->setLooping (shouldLoop);
+}
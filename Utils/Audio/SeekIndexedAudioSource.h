@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Drop-in replacement for AudioFormatReaderSource with constant-time seeking for
+// compressed files (mp3, ogg, m4a...).
+//
+// Compressed readers have to scan frames from the start (or from the last known
+// frame) on every setNextReadPosition. When a local compressed file is loaded, a
+// background job decodes it once into a seek index: a PCM cache file at the decoder's
+// own bit depth (float for mp3/ogg), kept beside the other cached indices, that is
+// memory-mapped so any sample can be addressed directly. Until the index is ready the
+// original reader is used; once it is, playback switches over at the current sample, so
+// the change is inaudible.
+//
+// Sources of the same file share its index. It is deleted when the last of them goes,
+// unless one of them set persistIndex; persisted ones are kept across sessions, but the
+// cache is trimmed to maxIndexCacheBytes (least recently used first, never one that is
+// in use) after every build.
+//
+// Shared by the player apps: add this file and its .cpp to the Projucer project.
+class SeekIndexedAudioSource : public juce::PositionableAudioSource
+{
+public:
+    // Takes ownership of the reader. sourceFile may be empty (e.g. non-local URLs),
+    // in which case no index is built and this behaves like AudioFormatReaderSource.
+    SeekIndexedAudioSource (juce::AudioFormatReader* reader, const juce::File& sourceFile,
+                            bool persistIndex = false);
+    ~SeekIndexedAudioSource() override;
+
+    bool hasSeekIndex() const noexcept      { return indexActive.load(); }
+
+    // Worst of 32 random seek + 512-sample reads on the index, measured when it was
+    // opened; 0 while there is no index.
+    double getIndexSeekLatencyMs() const noexcept   { return indexSeekLatencyMs.load(); }
+
+    static constexpr juce::int64 maxIndexCacheBytes = (juce::int64) 1 << 30;
+
+    // Formats that benefit from an index (sample-addressable formats don't need one)
+    static bool needsSeekIndex (const juce::File& file);
+
+    // Where the index for a given file lives; keyed by path, size, modification time and
+    // the bit depth it is stored at
+    static juce::File getIndexFileFor (const juce::File& file, const juce::AudioFormatReader& reader);
+    static int getIndexBitDepth (const juce::AudioFormatReader& reader);
+
+    // Deletes the least recently used indices until the cache fits in maxIndexCacheBytes
+    // (the most recent one and those in use always stay)
+    static void trimIndexCache();
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+    void setNextReadPosition (juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping (bool shouldLoop) override;
+
+private:
+    class IndexBuildJob;
+
+    juce::AudioFormatReaderSource compressedSource;
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> indexReader;
+    std::unique_ptr<juce::AudioFormatReaderSource> indexedSource;
+
+    juce::File sourceFile;
+    juce::File indexFile;
+    bool persistIndex = false;
+
+    std::unique_ptr<IndexBuildJob> buildJob;
+    std::atomic<bool> indexReady  { false }; // set by the build job
+    std::atomic<bool> indexActive { false }; // set by the reading thread once switched
+    std::atomic<double> indexSeekLatencyMs { 0.0 };
+
+    juce::PositionableAudioSource& getActiveSource() noexcept;
+    const juce::PositionableAudioSource& getActiveSource() const noexcept;
+
+    bool openIndex();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeekIndexedAudioSource)
+};
@@ -0,0 +1,278 @@
+#include "ThreadedRecorder.h"
+
+ThreadedRecorder::ThreadedRecorder()
+{
+    writerThread.addTimeSliceClient (this);
+    writerThread.startThread();
+}
+
+ThreadedRecorder::~ThreadedRecorder()
+{
+    stop();
+    writerThread.removeTimeSliceClient (this);
+    writerThread.stopThread (2000);
+}
+
+void ThreadedRecorder::prepareToPlay (double sampleRate, int numChannels)
+{
+    numChannels = juce::jmax (1, numChannels);
+
+    // Same format: keep the writer and the FIFO, the take just continues
+    if (recording.load() && sampleRate == currentSampleRate && numChannels == fifoBuffer.getNumChannels())
+        return;
+
+    if (recording.load())
+    {
+        stop();
+        stoppedByDevice.store (true);
+    }
+
+    const juce::ScopedLock sl (writerLock);
+    currentSampleRate = sampleRate;
+
+    const int capacity = juce::jmax (4096, (int) std::ceil (fifoSeconds * sampleRate));
+    fifoBuffer.setSize (numChannels, capacity);
+    fifo.setTotalSize (capacity);
+}
+
+//==============================================================================
+bool ThreadedRecorder::start (const juce::File& file, Format format)
+{
+    stop();
+
+    if (currentSampleRate <= 0.0)
+        return false;
+
+    file.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> out (file.createOutputStream());
+    if (out == nullptr)
+        return false;
+
+    std::unique_ptr<juce::AudioFormat> audioFormat;
+    if (format == Format::flac)
+        audioFormat = std::make_unique<juce::FlacAudioFormat>();
+    else
+        audioFormat = std::make_unique<juce::WavAudioFormat>();
+
+    std::unique_ptr<juce::AudioFormatWriter> newWriter (audioFormat->createWriterFor (out.get(), currentSampleRate,
+                                                                                       (unsigned int) fifoBuffer.getNumChannels(),
+                                                                                       24, {}, 0));
+    if (newWriter == nullptr)
+        return false;
+
+    out.release(); // now owned by the writer
+
+    {
+        const juce::ScopedLock sl (writerLock);
+
+        // Discard anything left from a previous take from the consumer side,
+        // which is safe while the audio thread may still be pushing
+        fifo.finishedRead (fifo.getNumReady());
+
+        writer = std::move (newWriter);
+        currentFile = file;
+        droppedSamples.store (0);
+        recordedSamples.store (0);
+        stoppedByDevice.store (false);
+    }
+
+    recording.store (true);
+    return true;
+}
+
+void ThreadedRecorder::stop()
+{
+    if (! recording.exchange (false))
+        return;
+
+    // Flush what the audio thread already queued, then close the file
+    const juce::ScopedLock sl (writerLock);
+    drainFifo();
+    writer.reset();
+}
+
+//==============================================================================
+void ThreadedRecorder::pushBlock (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    if (! recording.load() || numSamples <= 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+    const int numWritten = size1 + size2;
+    const int numChans = juce::jmin (buffer.getNumChannels(), fifoBuffer.getNumChannels());
+
+    for (int ch = 0; ch < fifoBuffer.getNumChannels(); ++ch)
+    {
+        if (ch < numChans)
+        {
+            if (size1 > 0) fifoBuffer.copyFrom (ch, start1, buffer, ch, startSample, size1);
+            if (size2 > 0) fifoBuffer.copyFrom (ch, start2, buffer, ch, startSample + size1, size2);
+        }
+        else
+        {
+            // e.g. a mono device feeding a stereo file
+            if (size1 > 0) fifoBuffer.clear (ch, start1, size1);
+            if (size2 > 0) fifoBuffer.clear (ch, start2, size2);
+        }
+    }
+
+    fifo.finishedWrite (numWritten);
+
+    // Disk fell behind: drop the rest of this block rather than wait
+    if (numWritten < numSamples)
+        droppedSamples.fetch_add (numSamples - numWritten);
+}
+
+//==============================================================================
+int ThreadedRecorder::useTimeSlice()
+{
+    const juce::ScopedLock sl (writerLock);
+
+    if (writer == nullptr)
+        return 50;
+
+    drainFifo();
+
+    // Poll often enough that the FIFO stays mostly empty
+    return 10;
+}
+
+void ThreadedRecorder::drainFifo()
+{
+    if (writer == nullptr)
+        return;
+
+    const int numReady = fifo.getNumReady();
+    if (numReady <= 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+    if (size1 > 0) writer->writeFromAudioSampleBuffer (fifoBuffer, start1, size1);
+    if (size2 > 0) writer->writeFromAudioSampleBuffer (fifoBuffer, start2, size2);
+
+    fifo.finishedRead (size1 + size2);
+    recordedSamples.fetch_add (size1 + size2);
+}
+
+//==============================================================================
+// RecorderControls
+
+RecorderControls::RecorderControls (ThreadedRecorder& recorderToControl)
+    : recorder (recorderToControl)
+{
+    formatBox.addItem ("WAV",  1);
+    formatBox.addItem ("FLAC", 2);
+    formatBox.setSelectedId (1, juce::dontSendNotification);
+    addAndMakeVisible (formatBox);
+
+    recordButton.setColour (juce::TextButton::buttonOnColourId, juce::Colours::red);
+    recordButton.setClickingTogglesState (false);
+    recordButton.onClick = [this]
+    {
+        if (recorder.isRecording())
+        {
+            recorder.stop();
+            updateStatus();
+        }
+        else
+        {
+            chooseFileAndStart();
+        }
+    };
+    addAndMakeVisible (recordButton);
+
+    addAndMakeVisible (statusLabel);
+    updateStatus();
+}
+
+RecorderControls::~RecorderControls()
+{
+    stopTimer();
+}
+
+void RecorderControls::resized()
+{
+    auto row = getLocalBounds();
+    recordButton.setBounds (row.removeFromLeft (100));
+    row.removeFromLeft (10);
+    formatBox.setBounds (row.removeFromLeft (90));
+    row.removeFromLeft (10);
+    statusLabel.setBounds (row);
+}
+
+void RecorderControls::chooseFileAndStart()
+{
+    const bool flac = formatBox.getSelectedId() == 2;
+
+    chooser = std::make_shared<juce::FileChooser> ("Record to file...",
+                                                   juce::File::getSpecialLocation (juce::File::userMusicDirectory)
+                                                       .getChildFile (flac ? "recording.flac" : "recording.wav"),
+                                                   flac ? "*.flac" : "*.wav");
+    auto flags = juce::FileBrowserComponent::saveMode
+               | juce::FileBrowserComponent::canSelectFiles
+               | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    chooser->launchAsync (flags, [this, flac] (const juce::FileChooser& fc)
+    {
+        auto file = fc.getResult();
+        if (file == juce::File())
+            return;
+
+        recorder.start (file, flac ? ThreadedRecorder::Format::flac : ThreadedRecorder::Format::wav);
+        updateStatus();
+    });
+}
+
+void RecorderControls::updateStatus()
+{
+    const bool isRecording = recorder.isRecording();
+
+    recordButton.setButtonText (isRecording ? "Stop rec" : "Record");
+    recordButton.setToggleState (isRecording, juce::dontSendNotification);
+    formatBox.setEnabled (! isRecording);
+
+    if (isRecording)
+    {
+        if (! isTimerRunning())
+            startTimerHz (4);
+    }
+    else
+    {
+        stopTimer();
+    }
+
+    timerCallback();
+}
+
+void RecorderControls::timerCallback()
+{
+    // the take can also end on the audio side (device restarted with another format)
+    if (isTimerRunning() && ! recorder.isRecording())
+    {
+        updateStatus();
+        return;
+    }
+
+    const auto file = recorder.getCurrentFile();
+    if (file == juce::File())
+    {
+        statusLabel.setText ({}, juce::dontSendNotification);
+        return;
+    }
+
+    const auto dropped = recorder.getNumDroppedSamples();
+    const bool stoppedByDevice = recorder.wasStoppedByDevice();
+
+    statusLabel.setText (file.getFileName()
+                           + "   " + juce::String (recorder.getNumRecordedSamples()) + " samples"
+                           + "   dropped: " + juce::String (dropped)
+                           + (stoppedByDevice ? "   stopped: audio device format changed" : ""),
+                         juce::dontSendNotification);
+    statusLabel.setColour (juce::Label::textColourId, stoppedByDevice ? juce::Colours::red
+                                                    : dropped > 0     ? juce::Colours::orange
+                                                                      : juce::Colours::white);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Records what an app renders to a WAV or FLAC file.
+//
+// Same idea as AudioFormatWriter::ThreadedWriter: the audio callback pushes samples
+// into a preallocated single-producer / single-consumer FIFO (no allocation, no locks),
+// and a background thread drains it to disk. If the disk falls behind and the FIFO
+// fills up, the samples that don't fit are dropped and counted instead of blocking.
+//
+// A take survives a device restart with the same rate and channel count (the samples
+// the device didn't render in between are simply missing). If the format changes the
+// file is closed, and wasStoppedByDevice() tells the UI why.
+//
+// Shared by the apps: add this file and its .cpp to the Projucer project.
+class ThreadedRecorder : private juce::TimeSliceClient
+{
+public:
+    enum class Format { wav, flac };
+
+    ThreadedRecorder();
+    ~ThreadedRecorder() override;
+
+    // Allocates the FIFO; call from prepareToPlay. A recording in progress carries on if
+    // the format is unchanged, otherwise it is stopped.
+    void prepareToPlay (double sampleRate, int numChannels);
+
+    // message thread
+    bool start (const juce::File& file, Format format);
+    void stop();
+    bool isRecording() const noexcept                 { return recording.load(); }
+
+    // The last take was closed by prepareToPlay because the device format changed
+    bool wasStoppedByDevice() const noexcept          { return stoppedByDevice.load(); }
+    const juce::File& getCurrentFile() const noexcept { return currentFile; }
+
+    // Audio thread: wait-free, never allocates
+    void pushBlock (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    // Samples lost because the writer thread couldn't keep up (since start())
+    juce::int64 getNumDroppedSamples() const noexcept { return droppedSamples.load(); }
+    juce::int64 getNumRecordedSamples() const noexcept { return recordedSamples.load(); }
+
+private:
+    static constexpr double fifoSeconds = 4.0;
+
+    juce::TimeSliceThread writerThread { "Recorder writer" };
+
+    juce::AbstractFifo fifo { 1 };
+    juce::AudioBuffer<float> fifoBuffer;
+    double currentSampleRate = 0.0;
+
+    juce::CriticalSection writerLock; // message thread and writer thread only
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    juce::File currentFile;
+
+    std::atomic<bool> recording { false };
+    std::atomic<bool> stoppedByDevice { false };
+    std::atomic<juce::int64> droppedSamples { 0 };
+    std::atomic<juce::int64> recordedSamples { 0 };
+
+    int useTimeSlice() override;
+    void drainFifo(); // writer side; called with writerLock held
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadedRecorder)
+};
+
+//==============================================================================
+// Record button + format selector + status line (elapsed time, dropped samples)
+class RecorderControls : public juce::Component,
+                         private juce::Timer
+{
+public:
+    explicit RecorderControls (ThreadedRecorder& recorderToControl);
+    ~RecorderControls() override;
+
+    void resized() override;
+
+private:
+    ThreadedRecorder& recorder;
+
+    juce::TextButton recordButton { "Record" };
+    juce::ComboBox   formatBox;
+    juce::Label      statusLabel;
+
+    std::shared_ptr<juce::FileChooser> chooser;
+
+    void chooseFileAndStart();
+    void updateStatus();
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RecorderControls)
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayLine.h"
+#include "LfoBank.h"
+#include "RealtimeParams.h"
+
+//==============================================================================
+// Multi-voice chorus / ensemble for up to maxChannels channels.
+//
+// Each channel is written once into a shared DelayLine (one lane per channel) and
+// 2 to 8 voices read it back at their own modulated delays. A voice has its own centre
+// delay (spread +/-25% around the delay time), LFO phase (evenly spaced) and a slightly
+// detuned LFO rate, which is what makes it sound like an ensemble instead of one wide
+// flanger. Channels use the same LFOs with the centre delays rotated, so they decorrelate
+// without running more LFOs.
+//
+// Per sample the voice delays are computed as one loop over the voices, the LFOs come
+// from an LfoBank a chunk at a time, and the fractional reads go through
+// DelayLine::readTaps(), so the work vectorises across voices rather than running one
+// flanger per voice.
+//
+// Parameters come in through RealtimeParams and are picked up once per block; delay,
+// depth and mix are smoothed per sample.
+class Chorus
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr int maxVoices = 8;
+
+    struct Parameters
+    {
+        int numVoices = 4;          // 2 .. 8
+        float rateHz = 0.8f;
+        float depthMs = 2.5f;       // LFO swing around each voice's delay
+        float delayMs = 15.0f;      // centre delay
+        float mix = 0.0f;           // 0 dry .. 1 wet
+    };
+
+    Chorus() = default;
+
+    //==============================================================================
+    // message thread (audio stopped)
+    void prepare (double sampleRate, int numChannelsToUse)
+    {
+        currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+        numChannels = juce::jlimit (1, maxChannels, numChannelsToUse);
+
+        // longest voice: 1.25 x the longest delay, plus the full depth
+        const int maxDelaySamples = (int) std::ceil ((1.25 * maxDelayMs + maxDepthMs) * 0.001 * currentSampleRate) + 2;
+        line.prepare (maxDelaySamples, numChannels);
+
+        lfo.prepare (currentSampleRate);
+
+        const auto& p = params.read();
+        delaySmoother.reset (currentSampleRate, 0.1);
+        depthSmoother.reset (currentSampleRate, 0.1);
+        mixSmoother.reset (currentSampleRate, 0.05);
+        delaySmoother.setCurrentAndTargetValue (msToSamples (p.delayMs));
+        depthSmoother.setCurrentAndTargetValue (msToSamples (p.depthMs));
+        mixSmoother.setCurrentAndTargetValue (p.mix);
+
+        configuredVoices = 0; // set the voices up on the next block
+        reset();
+    }
+
+    void release()
+    {
+        line.release();
+    }
+
+    void reset() noexcept
+    {
+        line.reset();
+        lfo.reset();
+    }
+
+    // message thread (a single writer)
+    void setParameters (const Parameters& newParams) noexcept
+    {
+        auto p = newParams;
+        p.numVoices = juce::jlimit (2, maxVoices, p.numVoices);
+        p.rateHz = juce::jlimit (0.01f, 10.0f, p.rateHz);
+        p.delayMs = juce::jlimit (minDelayMs, maxDelayMs, p.delayMs);
+        p.depthMs = juce::jlimit (0.0f, juce::jmin (maxDepthMs, 0.7f * p.delayMs), p.depthMs); // shortest voice stays > 0
+        p.mix = juce::jlimit (0.0f, 1.0f, p.mix);
+        params.write (p);
+    }
+
+    const Parameters& getParameters() const noexcept    { return params.getLastWritten(); }
+
+    //==============================================================================
+    // audio thread: the first prepared number of channels, in place
+    void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+    {
+        if (! line.isPrepared() || numSamples <= 0)
+            return;
+
+        const auto& p = params.read();
+        const int numChans = juce::jmin (numChannels, buffer.getNumChannels());
+
+        if (p.numVoices != configuredVoices || p.rateHz != configuredRate)
+            configureVoices (p.numVoices, p.rateHz);
+
+        delaySmoother.setTargetValue (msToSamples (p.delayMs));
+        depthSmoother.setTargetValue (msToSamples (p.depthMs));
+        mixSmoother.setTargetValue (p.mix);
+
+        // Fully dry and settled: skip the voices but keep the line running, so turning
+        // the mix up starts from the recent input rather than an old block
+        const bool bypassed = p.mix <= 0.0f && ! mixSmoother.isSmoothing();
+
+        float* channels[maxChannels];
+        for (int ch = 0; ch < numChans; ++ch)
+            channels[ch] = buffer.getWritePointer (ch, startSample);
+
+        const int numVoices = configuredVoices;
+        const float voiceGain = 1.0f / std::sqrt ((float) numVoices);
+
+        for (int start = 0; start < numSamples; start += lfoChunkSize)
+        {
+            const int n = juce::jmin (lfoChunkSize, numSamples - start);
+
+            if (! bypassed)
+                lfo.process (lfoValues, n);
+
+            for (int i = 0; i < n; ++i)
+            {
+                const float delay = delaySmoother.getNextValue();
+                const float depth = depthSmoother.getNextValue();
+                const float mix = mixSmoother.getNextValue();
+                float* frame = line.getWriteFrame();
+
+                for (int ch = 0; ch < numChans; ++ch)
+                {
+                    float* io = channels[ch] + start + i;
+                    const float in = *io;
+
+                    if (! bypassed)
+                    {
+                        const float* lfoFrame = lfoValues + (size_t) i * maxVoices;
+                        const float* factors = centreFactor[ch];
+
+                        alignas (32) float delays[maxVoices], taps[maxVoices];
+                        for (int v = 0; v < numVoices; ++v)
+                            delays[v] = delay * factors[v] + depth * lfoFrame[v];
+
+                        line.readTaps (ch, delays, taps, numVoices);
+
+                        float wet = 0.0f;
+                        for (int v = 0; v < numVoices; ++v)
+                            wet += taps[v];
+
+                        *io = (1.0f - mix) * in + mix * voiceGain * wet;
+                    }
+
+                    frame[ch] = in;
+                }
+
+                line.advance();
+            }
+        }
+    }
+
+private:
+    static constexpr float minDelayMs = 5.0f;
+    static constexpr float maxDelayMs = 40.0f;
+    static constexpr float maxDepthMs = 10.0f;
+    static constexpr int lfoChunkSize = 256;
+
+    DelayLine<float, DelayLineInterpolation::Linear> line; // lane = channel
+    LfoBank<maxVoices> lfo;                                // lane = voice
+    alignas (32) float lfoValues[lfoChunkSize * maxVoices] {};
+
+    // centre delay of voice v on channel ch, as a multiple of the delay time
+    alignas (32) float centreFactor[maxChannels][maxVoices] {};
+
+    int numChannels = 0;
+    int configuredVoices = 0;
+    float configuredRate = 0.0f;
+    double currentSampleRate = 44100.0;
+
+    RealtimeParams<Parameters> params;
+    juce::SmoothedValue<float> delaySmoother, depthSmoother, mixSmoother;
+
+    float msToSamples (float ms) const noexcept     { return ms * 0.001f * (float) currentSampleRate; }
+
+    void configureVoices (int numVoices, float rateHz) noexcept
+    {
+        const bool voicesChanged = numVoices != configuredVoices;
+        configuredVoices = numVoices;
+        configuredRate = rateHz;
+
+        for (int v = 0; v < maxVoices; ++v)
+        {
+            const float position = (float) v / (float) (numVoices - 1); // 0 .. 1 across the voices
+
+            lfo.setShape (v, LfoShape::Sine);
+            lfo.setFrequency (v, rateHz * (0.9f + 0.2f * position));    // +/-10% detune
+            lfo.setPhaseOffset (v, (float) v / (float) numVoices);
+        }
+
+        for (int ch = 0; ch < maxChannels; ++ch)
+            for (int v = 0; v < numVoices; ++v)
+                centreFactor[ch][v] = 0.75f + 0.5f * (float) ((v + ch) % numVoices) / (float) (numVoices - 1);
+
+        if (voicesChanged)
+            lfo.reset(); // apply the new phase spread
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Chorus)
+};
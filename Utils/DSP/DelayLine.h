@@ -0,0 +1,410 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayLineStorage.h"
+
+//==============================================================================
+// Interpolation used by DelayLine to read between samples (chosen at compile time)
+namespace DelayLineInterpolation
+{
+    struct None {};        // integer delay, rounded to the nearest sample
+    struct Linear {};      // 2 points
+    struct Lagrange3rd {}; // 4 points, 3rd-order Lagrange
+    struct Hermite {};     // 4 points, 3rd-order Hermite (Catmull-Rom)
+}
+
+//==============================================================================
+// Circular delay buffer shared by the delay, flanger and synth-delay code.
+//
+// - Power-of-two length, so the read/write indices wrap with a bitmask
+//   (Pirkle, "Designing Audio Effect Plugins in C++", 14.3).
+// - Fractional reads with the interpolation chosen by the template argument.
+// - Optional per-sample smoothing of the delay time: setDelay() sets a target and
+//   getNextDelay() ramps towards it, so moving the time control doesn't click.
+// - Channels are stored interleaved (one frame = all channels at one time index).
+//   frameStride can pad a frame to a SIMD-friendly width; readFrame() then reads
+//   every lane of a frame with a single position/fraction computation.
+// - The buffer can be kept in a compact format (see DelayLineStorage) for long delays.
+//   The interface stays float: frames are written to a one-frame staging area that
+//   advance() encodes, and span processing decodes/encodes whole runs around the span
+//   function, so code written against the float buffer works unchanged.
+//
+// Usage per sample: d = getNextDelay(); y = read (ch, d); write (ch, x + fb * y); advance();
+template <typename SampleType,
+          typename Interpolation = DelayLineInterpolation::Linear,
+          typename Storage = DelayLineStorage::Float32>
+class DelayLine
+{
+public:
+    static constexpr bool isCompact = ! std::is_same<Storage, DelayLineStorage::Float32>::value;
+    static_assert (! isCompact || std::is_same<SampleType, float>::value, "compact storage holds float samples");
+
+    DelayLine() = default;
+
+    //==============================================================================
+    // Allocates the buffer; call from prepareToPlay
+    void prepare (int maximumDelayInSamples, int numChannelsToUse, int frameStride = 0)
+    {
+        jassert (maximumDelayInSamples > 0 && numChannelsToUse > 0);
+
+        numChannels = juce::jmax (1, numChannelsToUse);
+        stride = juce::jmax (numChannels, frameStride);
+        maxDelay = juce::jmax (getMinimumDelay(), maximumDelayInSamples);
+
+        // +4: room for the interpolator's extra points
+        const int length = juce::nextPowerOfTwo (maxDelay + 4);
+        mask = length - 1;
+
+        if constexpr (isCompact)
+        {
+            packed.allocate ((size_t) length * (size_t) stride * (size_t) Storage::bytesPerSample, true);
+            scratch.allocate ((size_t) stride * (size_t) (1 + 2 * scratchFrames), true);
+        }
+        else
+        {
+            buffer.allocate ((size_t) length * (size_t) stride, true);
+        }
+
+        writePos = 0;
+
+        delaySmoother.setCurrentAndTargetValue (clampDelay (delaySmoother.getTargetValue()));
+    }
+
+    void release()
+    {
+        buffer.free();
+        packed.free();
+        scratch.free();
+        mask = 0;
+        writePos = 0;
+    }
+
+    void reset() noexcept
+    {
+        // all-zero bytes are 0.0 in every storage format
+        if (buffer != nullptr)
+            std::fill (buffer.get(), buffer.get() + (size_t) (mask + 1) * (size_t) stride, SampleType (0));
+
+        if (packed != nullptr)
+        {
+            std::fill (packed.get(), packed.get() + getMemoryBytes(), (juce::uint8) 0);
+            std::fill (scratch.get(), scratch.get() + stride, SampleType (0));
+        }
+
+        writePos = 0;
+        delaySmoother.setCurrentAndTargetValue (delaySmoother.getTargetValue());
+    }
+
+    bool isPrepared() const noexcept                 { return isCompact ? packed != nullptr : buffer != nullptr; }
+    int getNumChannels() const noexcept              { return numChannels; }
+    int getStride() const noexcept                   { return stride; }
+    int getMaximumDelayInSamples() const noexcept    { return maxDelay; }
+
+    // Size of the sample buffer (the compact formats' scratch frames aren't counted)
+    size_t getMemoryBytes() const noexcept
+    {
+        return isPrepared() ? (size_t) (mask + 1) * (size_t) stride * (size_t) Storage::bytesPerSample : 0;
+    }
+
+    // Smallest delay the interpolator can read without touching the frame being written
+    static constexpr int getMinimumDelay() noexcept
+    {
+        return std::is_same<Interpolation, DelayLineInterpolation::Lagrange3rd>::value
+            || std::is_same<Interpolation, DelayLineInterpolation::Hermite>::value ? 2 : 1;
+    }
+
+    //==============================================================================
+    // Delay time (audio thread)
+
+    // Ramp length used when the delay time changes (0 = jump)
+    void setSmoothingTime (double sampleRate, double rampSeconds)
+    {
+        delaySmoother.reset (sampleRate, rampSeconds);
+    }
+
+    void setDelay (SampleType newDelayInSamples, bool jumpImmediately = false) noexcept
+    {
+        if (jumpImmediately)
+            delaySmoother.setCurrentAndTargetValue (clampDelay (newDelayInSamples));
+        else
+            delaySmoother.setTargetValue (clampDelay (newDelayInSamples));
+    }
+
+    SampleType getTargetDelay() const noexcept       { return delaySmoother.getTargetValue(); }
+    SampleType getNextDelay() noexcept               { return delaySmoother.getNextValue(); }
+    bool isSmoothing() const noexcept                { return delaySmoother.isSmoothing(); }
+
+    //==============================================================================
+    // Reads `delayInSamples` behind the write head (call before write() for this frame)
+    SampleType read (int channel, SampleType delayInSamples) const noexcept
+    {
+        jassert (juce::isPositiveAndBelow (channel, numChannels));
+        return interpolate (channel, clampDelay (delayInSamples));
+    }
+
+    // Reads all `getStride()` lanes of one frame into dest
+    void readFrame (SampleType delayInSamples, SampleType* dest) const noexcept
+    {
+        const SampleType delay = clampDelay (delayInSamples);
+
+        for (int lane = 0; lane < stride; ++lane)
+            dest[lane] = interpolate (lane, delay);
+    }
+
+    // Lane i of the frame delaySamples[i] behind the write head, for every lane: each lane
+    // used as its own line with its own integer length (e.g. a feedback delay network)
+    void readLanes (const int* delaySamples, SampleType* dest) const noexcept
+    {
+        for (int lane = 0; lane < stride; ++lane)
+            dest[lane] = sampleAt (lane, writePos - delaySamples[lane]);
+    }
+
+    // Several fractional taps of one channel (e.g. chorus voices): the positions and
+    // fractions of all taps are computed in one pass, the points gathered, then the taps
+    // interpolated in another pass, so the arithmetic vectorises across taps.
+    // The delays aren't clamped: keep them within [getMinimumDelay(), getMaximumDelayInSamples()].
+    void readTaps (int channel, const SampleType* delaysInSamples, SampleType* dest, int numTaps) const noexcept
+    {
+        jassert (juce::isPositiveAndBelow (channel, numChannels));
+
+        if constexpr (std::is_same<Interpolation, DelayLineInterpolation::Linear>::value)
+        {
+            constexpr int maxBatch = 16;
+
+            for (int start = 0; start < numTaps; start += maxBatch)
+            {
+                const int n = juce::jmin (maxBatch, numTaps - start);
+                int index[maxBatch];
+                SampleType frac[maxBatch], x0[maxBatch], x1[maxBatch];
+
+                for (int t = 0; t < n; ++t)
+                {
+                    const int d = (int) delaysInSamples[start + t];
+                    index[t] = writePos - d;
+                    frac[t] = delaysInSamples[start + t] - (SampleType) d;
+                }
+
+                for (int t = 0; t < n; ++t)
+                {
+                    x0[t] = sampleAt (channel, index[t]);
+                    x1[t] = sampleAt (channel, index[t] - 1);
+                }
+
+                for (int t = 0; t < n; ++t)
+                    dest[start + t] = x0[t] + frac[t] * (x1[t] - x0[t]);
+            }
+        }
+        else
+        {
+            for (int t = 0; t < numTaps; ++t)
+                dest[t] = interpolate (channel, delaysInSamples[t]);
+        }
+    }
+
+    void write (int channel, SampleType value) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (channel, numChannels));
+        getWriteFrame()[channel] = value;
+    }
+
+    // Frame at the write head: `getStride()` contiguous samples
+    // (compact storage: the staging frame, stored by advance())
+    SampleType* getWriteFrame() noexcept
+    {
+        if constexpr (isCompact)
+            return scratch.get();
+        else
+            return buffer.get() + (size_t) writePos * (size_t) stride;
+    }
+
+    // Moves the write head one frame forward
+    void advance() noexcept
+    {
+        if constexpr (isCompact)
+            Storage::encode (scratch.get(), packedFrame (writePos), stride);
+
+        writePos = (writePos + 1) & mask;
+    }
+
+    //==============================================================================
+    // Block processing at a constant integer delay.
+    //
+    // When the delay is at least one block long, the frames a block reads and the frames
+    // it writes don't overlap, and each side is at most two contiguous runs of the buffer.
+    // processSpans() splits the block into (at most three) spans where both runs are
+    // contiguous, calls fn (readFrames, writeFrames, offsetInBlock, numFrames) for each,
+    // and moves the write head past the block. No per-sample index or wrap logic, so the
+    // span bodies can be plain vector ops. Use the per-sample path when this returns false.
+    // With compact storage the spans are at most scratchFrames long and fn works on decoded
+    // copies: it must write every sample of writeFrames.
+    bool canProcessSpans (int delaySamples, int numSamples) const noexcept
+    {
+        return delaySamples >= juce::jmax (numSamples, getMinimumDelay())
+            && delaySamples + numSamples <= mask + 1;
+    }
+
+    template <typename SpanFunction>
+    void processSpans (int delaySamples, int numSamples, SpanFunction&& fn) noexcept
+    {
+        jassert (canProcessSpans (delaySamples, numSamples));
+
+        const int length = mask + 1;
+        int w = writePos;
+        int r = (writePos - delaySamples) & mask;
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int n = juce::jmin (numSamples - done, length - w, length - r);
+
+            if constexpr (isCompact)
+            {
+                SampleType* readScratch = scratch.get() + stride;
+                SampleType* writeScratch = readScratch + (size_t) scratchFrames * (size_t) stride;
+
+                for (int chunk = 0; chunk < n; chunk += scratchFrames)
+                {
+                    const int m = juce::jmin (scratchFrames, n - chunk);
+
+                    Storage::decode (packedFrame (r + chunk), readScratch, m * stride);
+                    fn ((const SampleType*) readScratch, writeScratch, done + chunk, m);
+                    Storage::encode (writeScratch, packedFrame (w + chunk), m * stride);
+                }
+            }
+            else
+            {
+                fn ((const SampleType*) buffer.get() + (size_t) r * (size_t) stride,
+                    buffer.get() + (size_t) w * (size_t) stride,
+                    done, n);
+            }
+
+            done += n;
+            w = (w + n) & mask;
+            r = (r + n) & mask;
+        }
+
+        writePos = w;
+    }
+
+    // Read-only counterpart for extra taps: calls fn (frames, offsetInBlock, numFrames) for the
+    // (at most two) contiguous runs holding the `numSamples` frames that start `delaySamples`
+    // behind the write head. The delay must be at least the block length, so nothing read
+    // here is overwritten while the block is processed. The write head doesn't move.
+    template <typename SpanFunction>
+    void readSpans (int delaySamples, int numSamples, SpanFunction&& fn) const noexcept
+    {
+        jassert (delaySamples >= numSamples && delaySamples <= mask);
+
+        const int length = mask + 1;
+        int r = (writePos - delaySamples) & mask;
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int n = juce::jmin (numSamples - done, length - r);
+
+            if constexpr (isCompact)
+            {
+                SampleType* readScratch = scratch.get() + stride;
+
+                for (int chunk = 0; chunk < n; chunk += scratchFrames)
+                {
+                    const int m = juce::jmin (scratchFrames, n - chunk);
+
+                    Storage::decode (packedFrame (r + chunk), readScratch, m * stride);
+                    fn ((const SampleType*) readScratch, done + chunk, m);
+                }
+            }
+            else
+            {
+                fn ((const SampleType*) buffer.get() + (size_t) r * (size_t) stride, done, n);
+            }
+
+            done += n;
+            r = (r + n) & mask;
+        }
+    }
+
+private:
+    // Compact storage converts at most this many frames at a time
+    static constexpr int scratchFrames = 256;
+
+    juce::HeapBlock<SampleType> buffer;   // (mask + 1) frames of `stride` samples (Float32)
+    juce::HeapBlock<juce::uint8> packed;  // the same, encoded (compact storage)
+    juce::HeapBlock<SampleType> scratch;  // compact: staging frame + decoded/encoded span chunks
+    int numChannels = 1;
+    int stride = 1;
+    int maxDelay = 1;
+    int mask = 0;
+    int writePos = 0;
+
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> delaySmoother { SampleType (1) };
+
+    SampleType clampDelay (SampleType d) const noexcept
+    {
+        return juce::jlimit ((SampleType) getMinimumDelay(), (SampleType) maxDelay, d);
+    }
+
+    juce::uint8* packedFrame (int frame) const noexcept
+    {
+        return packed.get() + (size_t) frame * (size_t) stride * (size_t) Storage::bytesPerSample;
+    }
+
+    SampleType sampleAt (int lane, int index) const noexcept
+    {
+        const size_t i = (size_t) (index & mask) * (size_t) stride + (size_t) lane;
+
+        if constexpr (isCompact)
+            return Storage::read (packed.get(), i);
+        else
+            return buffer[i];
+    }
+
+    SampleType interpolate (int lane, SampleType delay) const noexcept
+    {
+        if constexpr (std::is_same<Interpolation, DelayLineInterpolation::None>::value)
+        {
+            return sampleAt (lane, writePos - juce::roundToInt (delay));
+        }
+        else
+        {
+            // Only the delay is split, never an absolute buffer position: a float position
+            // loses the fraction on long buffers (all of it from 2^22 frames on). The points
+            // are taken backwards from the integer delay, so the delay's own fractional part
+            // is the interpolation fraction. The delay is positive, so truncation == floor.
+            const int d = (int) delay;
+            const SampleType f = delay - (SampleType) d;
+            const int i = writePos - d;
+
+            const SampleType x0 = sampleAt (lane, i);
+            const SampleType x1 = sampleAt (lane, i - 1);
+
+            if constexpr (std::is_same<Interpolation, DelayLineInterpolation::Linear>::value)
+            {
+                return x0 + f * (x1 - x0);
+            }
+            else
+            {
+                const SampleType xm1 = sampleAt (lane, i + 1);
+                const SampleType x2  = sampleAt (lane, i - 2);
+
+                if constexpr (std::is_same<Interpolation, DelayLineInterpolation::Lagrange3rd>::value)
+                {
+                    // points at -1, 0, 1, 2 samples of delay past d
+                    const SampleType fp1 = f + 1, fm1 = f - 1, fm2 = f - 2;
+                    return xm1 * (-f * fm1 * fm2 / 6)
+                         + x0  * (fp1 * fm1 * fm2 / 2)
+                         + x1  * (-fp1 * f * fm2 / 2)
+                         + x2  * (fp1 * f * fm1 / 6);
+                }
+                else
+                {
+                    const SampleType c1 = SampleType (0.5) * (x1 - xm1);
+                    const SampleType c2 = xm1 - SampleType (2.5) * x0 + SampleType (2) * x1 - SampleType (0.5) * x2;
+                    const SampleType c3 = SampleType (0.5) * (x2 - xm1) + SampleType (1.5) * (x0 - x1);
+                    return ((c3 * f + c2) * f + c1) * f + x0;
+                }
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayLine)
+};
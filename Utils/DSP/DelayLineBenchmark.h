@@ -0,0 +1,259 @@
+#pragma once
+
+#include "DelayLine.h"
+
+//==============================================================================
+// Rough cost of each DelayLine interpolation (a modulated mono read + write per sample),
+// the speedup of the span-wise block path over the per-sample loop, and the memory and
+// throughput of each storage format, plus a check that fractional reads stay exact on the
+// longest buffers. Run by the Benchmarks console app.
+namespace DelayLineBenchmark
+{
+    // Fractional reads of a ramp from a line of `length` frames (a power of two), after the
+    // write head has wrapped: Lagrange and Hermite reproduce a ramp exactly, like linear.
+    // Returns the largest error in samples.
+    template <typename Interpolation>
+    inline double measureLargeBufferError (int length)
+    {
+        constexpr int period = 4096; // ramp 0..period-1, exact in float
+
+        DelayLine<float, Interpolation> line;
+        line.prepare (length - 4, 1);
+
+        const juce::int64 numWritten = (juce::int64) length + period / 2;
+        for (juce::int64 n = 0; n < numWritten; ++n)
+        {
+            line.write (0, (float) (n % period));
+            line.advance();
+        }
+
+        const int delays[] = { 3, 1000, 2000 };
+        const float fractions[] = { 0.25f, 0.5f, 0.75f };
+        double worst = 0.0;
+
+        for (int d : delays)
+        {
+            for (float f : fractions)
+            {
+                // the frame written last is 1 sample behind the write head
+                const double expected = (double) ((numWritten - d) % period) - (double) f;
+                worst = juce::jmax (worst, std::abs ((double) line.read (0, (float) d + f) - expected));
+
+                float tap = 0.0f;
+                const float tapDelay = (float) d + f;
+                line.readTaps (0, &tapDelay, &tap, 1);
+                worst = juce::jmax (worst, std::abs ((double) tap - expected));
+            }
+        }
+
+        return worst;
+    }
+
+    template <typename Interpolation>
+    inline double measureNsPerSample (int numSamples = 1 << 20)
+    {
+        constexpr int tableSize = 4096; // precomputed input and delay curve, so only the line is timed
+
+        std::vector<float> noise (tableSize), delays (tableSize);
+        juce::Random rng (1234);
+        for (int i = 0; i < tableSize; ++i)
+        {
+            noise[(size_t) i]  = rng.nextFloat() * 2.0f - 1.0f;
+            delays[(size_t) i] = 200.0f + 150.0f * std::sin ((float) i * juce::MathConstants<float>::twoPi / tableSize);
+        }
+
+        DelayLine<float, Interpolation> line;
+        line.prepare (1024, 1);
+
+        float sink = 0.0f;
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float y = line.read (0, delays[(size_t) (i & (tableSize - 1))]);
+            line.write (0, noise[(size_t) (i & (tableSize - 1))] + 0.5f * y);
+            line.advance();
+            sink += y;
+        }
+
+        const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+        volatile float keepAlive = sink; // stops the loop being optimised away
+        juce::ignoreUnused (keepAlive);
+
+        return seconds * 1.0e9 / (double) numSamples;
+    }
+
+    // Mono feedback delay (y = x + d, write x + fb * d) at a fixed delay, both ways;
+    // returns per-sample time / span time
+    inline double measureBlockSpeedup (int blockSize, int numBlocks = 4096)
+    {
+        const int delaySamples = juce::jmax (blockSize, 11025);
+        const float fb = 0.35f;
+
+        juce::AudioBuffer<float> block (1, blockSize);
+        juce::Random rng (99);
+        for (int i = 0; i < blockSize; ++i)
+            block.setSample (0, i, rng.nextFloat() * 2.0f - 1.0f);
+
+        DelayLine<float, DelayLineInterpolation::None> perSample, spans;
+        perSample.prepare (44100, 1);
+        spans.prepare (44100, 1);
+
+        auto timeIt = [&] (auto&& processBlock)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < numBlocks; ++b)
+                processBlock (block.getWritePointer (0));
+            return juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        };
+
+        const double perSampleSeconds = timeIt ([&] (float* data)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float delayed = perSample.read (0, (float) delaySamples);
+                perSample.write (0, data[i] + fb * delayed);
+                data[i] = 0.5f * (data[i] + delayed); // keeps the signal bounded across blocks
+                perSample.advance();
+            }
+        });
+
+        const double spanSeconds = timeIt ([&] (float* data)
+        {
+            spans.processSpans (delaySamples, blockSize, [&] (const float* delayed, float* written, int offset, int n)
+            {
+                float* io = data + offset;
+                juce::FloatVectorOperations::copy (written, io, n);
+                juce::FloatVectorOperations::addWithMultiply (written, delayed, fb, n);
+                juce::FloatVectorOperations::add (io, delayed, n);
+                juce::FloatVectorOperations::multiply (io, 0.5f, n);
+            });
+        });
+
+        return spanSeconds > 0.0 ? perSampleSeconds / spanSeconds : 0.0;
+    }
+
+    // Stereo feedback delay of `seconds` at 48 kHz in the given storage: buffer size in MB,
+    // and ns per stereo frame for the per-sample loop and the span path (512-sample blocks)
+    struct StorageFigures { double megabytes, perSampleNs, spanNs; };
+
+    template <typename Storage>
+    inline StorageFigures measureStorage (double seconds = 60.0, int numBlocks = 2048)
+    {
+        constexpr int blockSize = 512;
+        const int delaySamples = (int) (seconds * 48000.0) - 8;
+        const float fb = 0.35f;
+
+        juce::AudioBuffer<float> block (2, blockSize);
+        juce::Random rng (7);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                block.setSample (ch, i, rng.nextFloat() * 2.0f - 1.0f);
+
+        DelayLine<float, DelayLineInterpolation::None, Storage> line;
+        line.prepare (delaySamples, 2);
+
+        auto timeIt = [&] (auto&& processBlock)
+        {
+            line.reset();
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int b = 0; b < numBlocks; ++b)
+                processBlock (block.getWritePointer (0), block.getWritePointer (1));
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+            return elapsed * 1.0e9 / ((double) numBlocks * blockSize);
+        };
+
+        StorageFigures figures;
+        figures.megabytes = (double) line.getMemoryBytes() / (1024.0 * 1024.0);
+
+        figures.perSampleNs = timeIt ([&] (float* left, float* right)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float dl = line.read (0, (float) delaySamples);
+                const float dr = line.read (1, (float) delaySamples);
+                line.write (0, left[i] + fb * dl);
+                line.write (1, right[i] + fb * dr);
+                line.advance();
+                left[i]  = 0.5f * (left[i] + dl);
+                right[i] = 0.5f * (right[i] + dr);
+            }
+        });
+
+        figures.spanNs = timeIt ([&] (float* left, float* right)
+        {
+            line.processSpans (delaySamples, blockSize, [&] (const float* delayed, float* written, int offset, int n)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    const float dl = delayed[2 * i], dr = delayed[2 * i + 1];
+                    float& l = left[offset + i];
+                    float& r = right[offset + i];
+                    written[2 * i]     = l + fb * dl;
+                    written[2 * i + 1] = r + fb * dr;
+                    l = 0.5f * (l + dl);
+                    r = 0.5f * (r + dr);
+                }
+            });
+        });
+
+        return figures;
+    }
+
+    template <typename Storage>
+    inline void logStorage (const char* name)
+    {
+        const auto f = measureStorage<Storage>();
+
+        juce::String line;
+        line << "DelayLine 60 s stereo @ 48 kHz, " << name << ": " << f.megabytes << " MB, ns/frame per-sample: "
+             << f.perSampleNs << "  spans: " << f.spanNs;
+        juce::Logger::writeToLog (line);
+    }
+
+    // 2^22 frames: 30 s at 96 kHz; 2^24: 60 s at 192 kHz (DelayApp's longest settings)
+    inline bool checkLargeBuffers()
+    {
+        bool passed = true;
+
+        for (int length : { 1 << 17, 1 << 22, 1 << 24 })
+        {
+            const double worst = juce::jmax (measureLargeBufferError<DelayLineInterpolation::Linear> (length),
+                                             measureLargeBufferError<DelayLineInterpolation::Lagrange3rd> (length),
+                                             measureLargeBufferError<DelayLineInterpolation::Hermite> (length));
+            const bool ok = worst < 1.0e-3;
+            passed = passed && ok;
+
+            juce::String line;
+            line << "DelayLine fractional read @ " << length << " frames: max error " << worst
+                 << (ok ? " (ok)" : " (FAILED)");
+            juce::Logger::writeToLog (line);
+        }
+
+        return passed;
+    }
+
+    inline bool logAll()
+    {
+        juce::String line;
+        line << "DelayLine ns/sample - none: "     << measureNsPerSample<DelayLineInterpolation::None>()
+             << "  linear: "    << measureNsPerSample<DelayLineInterpolation::Linear>()
+             << "  lagrange3: " << measureNsPerSample<DelayLineInterpolation::Lagrange3rd>()
+             << "  hermite: "   << measureNsPerSample<DelayLineInterpolation::Hermite>();
+        juce::Logger::writeToLog (line);
+
+        for (int blockSize = 64; blockSize <= 2048; blockSize *= 2)
+        {
+            line.clear();
+            line << "DelayLine span path speedup @ " << blockSize << " samples: " << measureBlockSpeedup (blockSize) << "x";
+            juce::Logger::writeToLog (line);
+        }
+
+        logStorage<DelayLineStorage::Float32> ("float32");
+        logStorage<DelayLineStorage::Float16> ("float16");
+        logStorage<DelayLineStorage::Packed24> ("packed24");
+
+        return checkLargeBuffers();
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Sample formats a DelayLine can keep its buffer in (chosen at compile time).
+//
+// Float32 is the plain float buffer. The compact formats trade precision for memory
+// (and cache): a 60 s stereo line at 192 kHz is 88 MB as floats, 44 MB as Float16 and
+// 66 MB as Packed24. DelayLine converts whole runs of samples at a time (encode/decode
+// below are straight loops over arrays the compiler vectorises) and single samples only
+// for fractional reads.
+namespace DelayLineStorage
+{
+    struct Float32
+    {
+        static constexpr int bytesPerSample = 4;
+    };
+
+    //==============================================================================
+    // IEEE 754 half precision: 11-bit mantissa (about -66 dB relative error), range
+    // +/-65504, no headroom limit in practice. Round to nearest even; values beyond the
+    // range clamp to the largest finite half instead of becoming infinite.
+    struct Float16
+    {
+        static constexpr int bytesPerSample = 2;
+
+        static juce::uint16 encodeOne (float value) noexcept
+        {
+            juce::uint32 bits;
+            std::memcpy (&bits, &value, sizeof (bits));
+
+            const juce::uint32 sign = (bits >> 16) & 0x8000u;
+            bits &= 0x7fffffffu;
+
+            juce::uint32 half;
+
+            if (bits >= 0x477ff000u)            // rounds past 65504 (or inf/nan): clamp
+            {
+                half = 0x7bffu;
+            }
+            else if (bits < 0x38800000u)        // below 2^-14: subnormal half
+            {
+                // Adding 0.5 lines the half's subnormal bits up with the float's mantissa
+                // and lets the FPU do the rounding
+                float f;
+                std::memcpy (&f, &bits, sizeof (f));
+                f += 0.5f;
+                std::memcpy (&half, &f, sizeof (half));
+                half -= 0x3f000000u;
+            }
+            else
+            {
+                const juce::uint32 mantissaOdd = (bits >> 13) & 1u;
+                bits += 0xc8000fffu + mantissaOdd; // rebias exponent (15 - 127), round to nearest even
+                half = bits >> 13;
+            }
+
+            return (juce::uint16) (half | sign);
+        }
+
+        static float decodeOne (juce::uint16 half) noexcept
+        {
+            juce::uint32 bits = ((juce::uint32) half & 0x7fffu) << 13;
+            const juce::uint32 exponent = bits & 0x0f800000u;
+            bits += 0x38000000u;                // rebias exponent (127 - 15)
+
+            float f;
+
+            if (exponent == 0)                  // zero or subnormal: renormalise via the FPU
+            {
+                bits += 0x00800000u;
+                std::memcpy (&f, &bits, sizeof (f));
+                f -= 6.103515625e-05f;          // 2^-14
+            }
+            else
+            {
+                std::memcpy (&f, &bits, sizeof (f));
+            }
+
+            return ((half & 0x8000u) != 0) ? -f : f;
+        }
+
+        static void encode (const float* source, juce::uint8* dest, int numSamples) noexcept
+        {
+            auto* out = reinterpret_cast<juce::uint16*> (dest);
+
+            for (int i = 0; i < numSamples; ++i)
+                out[i] = encodeOne (source[i]);
+        }
+
+        static void decode (const juce::uint8* source, float* dest, int numSamples) noexcept
+        {
+            auto* in = reinterpret_cast<const juce::uint16*> (source);
+
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = decodeOne (in[i]);
+        }
+
+        static float read (const juce::uint8* source, size_t index) noexcept
+        {
+            return decodeOne (reinterpret_cast<const juce::uint16*> (source)[index]);
+        }
+    };
+
+    //==============================================================================
+    // 24-bit fixed point, 3 bytes per sample, with 18 dB of headroom (+/-8.0 full scale) so
+    // a delay line carrying dry + feedback doesn't clip. Resolution is 2^-20 (about -120 dB).
+    struct Packed24
+    {
+        static constexpr int bytesPerSample = 3;
+        static constexpr float fullScale = 8.0f;
+
+        static void encode (const float* source, juce::uint8* dest, int numSamples) noexcept
+        {
+            constexpr float toInt = 8388607.0f / fullScale;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float clipped = juce::jlimit (-fullScale, fullScale, source[i]);
+                const auto v = (juce::uint32) (juce::int32) std::lrintf (clipped * toInt);
+
+                dest[3 * i]     = (juce::uint8) v;
+                dest[3 * i + 1] = (juce::uint8) (v >> 8);
+                dest[3 * i + 2] = (juce::uint8) (v >> 16);
+            }
+        }
+
+        static void decode (const juce::uint8* source, float* dest, int numSamples) noexcept
+        {
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = read (source, (size_t) i);
+        }
+
+        static float read (const juce::uint8* source, size_t index) noexcept
+        {
+            constexpr float toFloat = fullScale / 8388607.0f;
+
+            const juce::uint8* p = source + 3 * index;
+            const auto packed = (juce::uint32) p[0] | ((juce::uint32) p[1] << 8) | ((juce::uint32) p[2] << 16);
+
+            // move the sign bit to the top and shift back to sign-extend
+            return (float) ((juce::int32) (packed << 8) >> 8) * toFloat;
+        }
+    };
+}
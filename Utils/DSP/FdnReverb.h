@@ -0,0 +1,276 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayLine.h"
+#include "RealtimeParams.h"
+
+//==============================================================================
+// Feedback matrix used by FdnReverb (chosen at compile time)
+namespace FdnMatrix
+{
+    struct Hadamard {};    // dense mixing, applied as a fast Walsh-Hadamard transform (N log N adds)
+    struct Householder {}; // x - (2/N) * sum(x): cheaper, a little less diffuse
+}
+
+//==============================================================================
+// Feedback delay network reverb (Jot & Chaigne; Smith, "Physical Audio Signal Processing").
+//
+// NumLines (8 or 16) delay lines with mutually prime lengths (distinct primes) feed back
+// through an orthogonal matrix. Each loop has a one-pole lowpass (damping: highs die out
+// first) and a gain that gives every line the same decay time (RT60).
+//
+// All lines live in one DelayLine: lane i of each frame is line i, so the buffer is a single
+// contiguous allocation, a frame is written with one contiguous store and every per-line
+// step (damping, decay, matrix) is a loop over NumLines lanes the compiler vectorises.
+// The cost per sample is fixed: it doesn't depend on the decay, size or input.
+//
+// Stereo: even lines take the left input and feed the left output, odd lines the right.
+// Parameters come in through RealtimeParams and are picked up once per block; the mix
+// is smoothed per sample.
+template <int NumLines, typename Matrix = FdnMatrix::Hadamard>
+class FdnReverb
+{
+public:
+    static_assert (NumLines == 8 || NumLines == 16, "FdnReverb supports 8 or 16 lines");
+
+    struct Parameters
+    {
+        float decaySeconds = 2.0f;  // RT60
+        float damping = 0.3f;       // 0 (bright) .. 0.95 (dark)
+        float mix = 0.0f;           // 0 dry .. 1 wet
+    };
+
+    FdnReverb() = default;
+
+    //==============================================================================
+    // message thread (audio stopped): picks the line lengths and allocates the buffer.
+    // sizeScale stretches the room (line lengths run from about 20 to 80 ms at 1.0).
+    void prepare (double sampleRate, float sizeScale = 1.0f)
+    {
+        currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+
+        const double minLength = 0.020 * currentSampleRate * (double) sizeScale;
+        const double maxLength = 0.080 * currentSampleRate * (double) sizeScale;
+
+        // Geometric spread, each bumped to the next prime not used yet: distinct primes
+        // share no factors, so the echoes of different lines never line up periodically
+        for (int i = 0; i < NumLines; ++i)
+        {
+            const double target = minLength * std::pow (maxLength / minLength, (double) i / (double) (NumLines - 1));
+            int length = juce::jmax (3, (int) target);
+
+            while (! isPrime (length) || std::find (lineLength, lineLength + i, length) != lineLength + i)
+                ++length;
+
+            lineLength[i] = length;
+        }
+
+        lines.prepare (lineLength[NumLines - 1], NumLines, NumLines);
+
+        mixSmoother.reset (currentSampleRate, 0.05);
+        mixSmoother.setCurrentAndTargetValue (params.read().mix);
+        cachedDecay = -1.0f; // recompute the loop gains on the next block
+
+        reset();
+    }
+
+    void release()
+    {
+        lines.release();
+    }
+
+    void reset() noexcept
+    {
+        lines.reset();
+        std::fill (lowpassState, lowpassState + NumLines, 0.0f);
+    }
+
+    // message thread (a single writer)
+    void setParameters (const Parameters& newParams) noexcept
+    {
+        auto p = newParams;
+        p.decaySeconds = juce::jlimit (0.1f, 30.0f, p.decaySeconds);
+        p.damping = juce::jlimit (0.0f, 0.95f, p.damping);
+        p.mix = juce::jlimit (0.0f, 1.0f, p.mix);
+        params.write (p);
+    }
+
+    const Parameters& getParameters() const noexcept    { return params.getLastWritten(); }
+
+    int getLineLength (int line) const noexcept         { return lineLength[line]; }
+
+    //==============================================================================
+    // audio thread: the first one or two channels, in place
+    void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+    {
+        if (! lines.isPrepared() || numSamples <= 0 || buffer.getNumChannels() <= 0)
+            return;
+
+        const auto& p = params.read();
+        updateLoopGains (p.decaySeconds);
+        mixSmoother.setTargetValue (p.mix);
+
+        // Fully dry and settled: nothing to do. Clear the lines once, so an old tail
+        // doesn't come back when the mix is turned up again.
+        if (p.mix <= 0.0f && ! mixSmoother.isSmoothing())
+        {
+            if (! isCleared)
+                reset();
+
+            isCleared = true;
+            return;
+        }
+
+        isCleared = false;
+
+        const float damp = p.damping;
+        const bool stereo = buffer.getNumChannels() > 1;
+        float* left = buffer.getWritePointer (0, startSample);
+        float* right = stereo ? buffer.getWritePointer (1, startSample) : left;
+
+        alignas (32) float delayed[NumLines];
+        alignas (32) float x[NumLines];
+
+        // Loop state in locals for the block, so it can stay in registers
+        alignas (32) float lowpass[NumLines], gain[NumLines];
+        std::copy (lowpassState, lowpassState + NumLines, lowpass);
+        std::copy (loopGain, loopGain + NumLines, gain);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float inL = left[i];
+            const float inR = right[i];
+
+            lines.readLanes (lineLength, delayed);
+
+            // Damping and decay per line
+            for (int lane = 0; lane < NumLines; ++lane)
+            {
+                lowpass[lane] = delayed[lane] + damp * (lowpass[lane] - delayed[lane]);
+                x[lane] = gain[lane] * lowpass[lane];
+            }
+
+            applyMatrix (x);
+
+            // Feed back plus the input: even lanes left, odd lanes right
+            float* frame = lines.getWriteFrame();
+            for (int lane = 0; lane < NumLines; ++lane)
+                frame[lane] = x[lane] + inputGain * ((lane & 1) == 0 ? inL : inR);
+
+            lines.advance();
+
+            // Outputs: alternating signs decorrelate the sums further
+            float wetL = 0.0f, wetR = 0.0f;
+            for (int lane = 0; lane < NumLines; lane += 2)
+            {
+                wetL += outputSign (lane) * delayed[lane];
+                wetR += outputSign (lane) * delayed[lane + 1];
+            }
+
+            const float mix = mixSmoother.getNextValue();
+            const float dry = 1.0f - mix;
+            const float wet = mix * outputGain;
+
+            if (stereo)
+            {
+                left[i]  = dry * inL + wet * wetL;
+                right[i] = dry * inR + wet * wetR;
+            }
+            else
+            {
+                left[i] = dry * inL + wet * 0.5f * (wetL + wetR);
+            }
+        }
+
+        std::copy (lowpass, lowpass + NumLines, lowpassState);
+    }
+
+private:
+    DelayLine<float, DelayLineInterpolation::None> lines; // lane i = line i
+    int lineLength[NumLines] {};
+
+    alignas (32) float loopGain[NumLines] {};
+    alignas (32) float lowpassState[NumLines] {};
+    float cachedDecay = -1.0f;
+    bool isCleared = false;
+
+    double currentSampleRate = 44100.0;
+
+    RealtimeParams<Parameters> params;
+    juce::SmoothedValue<float> mixSmoother;
+
+    static constexpr float inputGain = 0.5f;
+    static constexpr float outputGain = 1.0f / (float) (NumLines / 2); // average of the summed lines
+
+    static constexpr float outputSign (int lane) noexcept { return ((lane >> 1) & 1) == 0 ? 1.0f : -1.0f; }
+
+    // Gain for a line of length L to lose 60 dB in decaySeconds: 10^(-3 L / (fs T60))
+    void updateLoopGains (float decaySeconds) noexcept
+    {
+        if (decaySeconds == cachedDecay)
+            return;
+
+        cachedDecay = decaySeconds;
+
+        for (int lane = 0; lane < NumLines; ++lane)
+            loopGain[lane] = std::pow (10.0f, -3.0f * (float) lineLength[lane] / ((float) currentSampleRate * decaySeconds));
+    }
+
+    static void applyMatrix (float* x) noexcept
+    {
+        if constexpr (std::is_same<Matrix, FdnMatrix::Hadamard>::value)
+        {
+            // Walsh-Hadamard butterflies, scaled by 1/sqrt(N) to stay orthogonal. Each stage
+            // is written as one pass over all lanes (fixed trip count) so it vectorises.
+            alignas (32) float y[NumLines];
+
+            hadamardStage<1> (x, y);
+            hadamardStage<2> (y, x);
+            hadamardStage<4> (x, y);
+
+            if constexpr (NumLines == 16)
+                hadamardStage<8> (y, x);
+            else
+                std::copy (y, y + NumLines, x);
+
+            constexpr float scale = NumLines == 8 ? 0.35355339f : 0.25f; // 1 / sqrt (N)
+            for (int lane = 0; lane < NumLines; ++lane)
+                x[lane] *= scale;
+        }
+        else
+        {
+            float sum = 0.0f;
+            for (int lane = 0; lane < NumLines; ++lane)
+                sum += x[lane];
+
+            const float reflection = sum * (2.0f / (float) NumLines);
+            for (int lane = 0; lane < NumLines; ++lane)
+                x[lane] -= reflection;
+        }
+    }
+
+    template <int H>
+    static void hadamardStage (const float* in, float* out) noexcept
+    {
+        for (int lane = 0; lane < NumLines; ++lane)
+        {
+            const float a = in[lane & ~H];
+            const float b = in[lane | H];
+            out[lane] = (lane & H) != 0 ? a - b : a + b;
+        }
+    }
+
+    static bool isPrime (int n) noexcept
+    {
+        if (n < 2)
+            return false;
+
+        for (int d = 2; d * d <= n; ++d)
+            if (n % d == 0)
+                return false;
+
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FdnReverb)
+};
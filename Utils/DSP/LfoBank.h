@@ -0,0 +1,263 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Waveforms an LfoBank lane can produce (all bipolar, -1 .. 1, starting at 0 phase)
+enum class LfoShape
+{
+    Sine,
+    Triangle,
+    Saw,            // rising ramp
+    Random,         // smooth random: glides to a new random value every cycle
+    SampleAndHold   // steps to a new random value every cycle
+};
+
+//==============================================================================
+// A bank of NumLfos low-frequency oscillators generated a block at a time.
+//
+// - The lanes run side by side: every per-sample step (phase, sine, triangle, saw,
+//   random) is a loop over the lanes with no branches, so 4 or 8 LFOs advance together
+//   in one SIMD register. Each lane computes every shape and keeps its own through a
+//   one-hot weight, which is cheaper than branching per lane.
+// - Sine by recursive rotation: (sin, cos) is rotated by the phase increment each
+//   sample (two multiply-adds), no std::sin per sample. Samples are generated in float
+//   in chunks; the phase is carried between chunks in double and the pair is re-seeded
+//   from it, so neither the rotation nor slow rates (tiny increments) drift.
+// - Random shapes take a new value from a per-lane xorshift generator when the phase wraps.
+// - Rate in Hz, or synced to a tempo (setTempoSync) and locked to a song position
+//   (syncToPpq) when there is a host transport.
+//
+// Output is interleaved: dest[i * NumLfos + lane].
+//
+// Everything but prepare() is meant for the audio thread; owners pass control values in
+// (e.g. once per block) the way they already do for their other parameters.
+template <int NumLfos>
+class LfoBank
+{
+public:
+    static_assert (NumLfos >= 1, "LfoBank needs at least one LFO");
+
+    LfoBank()
+    {
+        for (int lane = 0; lane < NumLfos; ++lane)
+        {
+            randomState[lane] = 0x9e3779b9u * (juce::uint32) (lane + 1);
+            setShape (lane, LfoShape::Sine);
+            setIncrement (lane, 0.0);
+        }
+    }
+
+    //==============================================================================
+    void prepare (double sampleRate)
+    {
+        currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+
+        for (int lane = 0; lane < NumLfos; ++lane)
+            setIncrement (lane, (double) frequencyHz[lane] / currentSampleRate);
+
+        reset();
+    }
+
+    // Back to phase 0 (plus each lane's offset)
+    void reset() noexcept
+    {
+        for (int lane = 0; lane < NumLfos; ++lane)
+        {
+            phase[lane] = phaseOffset[lane];
+            randomFrom[lane] = 0.0f;
+            randomTo[lane] = 0.0f;
+        }
+    }
+
+    static constexpr int getNumLfos() noexcept      { return NumLfos; }
+
+    //==============================================================================
+    void setShape (int lane, LfoShape newShape) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (lane, NumLfos));
+
+        shape[lane] = newShape;
+        weightSine[lane]     = newShape == LfoShape::Sine ? 1.0f : 0.0f;
+        weightTriangle[lane] = newShape == LfoShape::Triangle ? 1.0f : 0.0f;
+        weightSaw[lane]      = newShape == LfoShape::Saw ? 1.0f : 0.0f;
+        weightRandom[lane]   = newShape == LfoShape::Random ? 1.0f : 0.0f;
+        weightHold[lane]     = newShape == LfoShape::SampleAndHold ? 1.0f : 0.0f;
+    }
+
+    LfoShape getShape (int lane) const noexcept     { return shape[lane]; }
+
+    void setFrequency (int lane, float hz) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (lane, NumLfos));
+
+        if (hz == frequencyHz[lane])
+            return;
+
+        frequencyHz[lane] = hz;
+        setIncrement (lane, (double) hz / currentSampleRate);
+    }
+
+    // One cycle every beatsPerCycle quarter notes at the given tempo
+    // (e.g. 1 = a quarter note, 0.5 = an eighth, 4 = one bar of 4/4)
+    void setTempoSync (int lane, double bpm, double beatsPerCycle) noexcept
+    {
+        if (bpm > 0.0 && beatsPerCycle > 0.0)
+            setFrequency (lane, (float) (bpm / (60.0 * beatsPerCycle)));
+    }
+
+    // Puts a tempo-synced lane where it should be at a host song position (in quarter notes),
+    // so the LFO lines up with the bar however playback was started
+    void syncToPpq (int lane, double ppqPosition, double beatsPerCycle) noexcept
+    {
+        if (beatsPerCycle <= 0.0)
+            return;
+
+        const double cycles = ppqPosition / beatsPerCycle + (double) phaseOffset[lane];
+        phase[lane] = cycles - std::floor (cycles);
+    }
+
+    // Phase offset in cycles (0 .. 1), e.g. to spread chorus voices; applied on reset()
+    void setPhaseOffset (int lane, float offsetCycles) noexcept
+    {
+        phaseOffset[lane] = offsetCycles - std::floor (offsetCycles);
+    }
+
+    double getPhase (int lane) const noexcept       { return phase[lane]; }
+
+    //==============================================================================
+    // Writes numSamples frames of NumLfos values to dest (interleaved)
+    void process (float* dest, int numSamples) noexcept
+    {
+        while (numSamples > 0)
+        {
+            const int n = juce::jmin (numSamples, chunkSize);
+            processChunk (dest, n);
+            dest += (size_t) n * NumLfos;
+            numSamples -= n;
+        }
+    }
+
+private:
+    double phase[NumLfos] {};                   // cycles, 0 .. 1
+    double increment[NumLfos] {};               // cycles per sample
+    alignas (32) float rotationCos[NumLfos] {};
+    alignas (32) float rotationSin[NumLfos] {};
+
+    alignas (32) float weightSine[NumLfos] {};
+    alignas (32) float weightTriangle[NumLfos] {};
+    alignas (32) float weightSaw[NumLfos] {};
+    alignas (32) float weightRandom[NumLfos] {};
+    alignas (32) float weightHold[NumLfos] {};
+
+    alignas (32) float randomFrom[NumLfos] {};
+    alignas (32) float randomTo[NumLfos] {};
+    alignas (32) juce::uint32 randomState[NumLfos] {};
+
+    float frequencyHz[NumLfos] {};
+    float phaseOffset[NumLfos] {};
+    LfoShape shape[NumLfos] {};
+
+    double currentSampleRate = 44100.0;
+
+    // Frames per pass: the float phase within a pass is start + i * inc, precise enough
+    // up to a few hundred samples; the double phase takes over between passes
+    static constexpr int chunkSize = 256;
+
+    void processChunk (float* dest, int numSamples) noexcept
+    {
+        // Chunk state in aligned locals so the lane loops vectorise and stay in registers
+        alignas (32) float start[NumLfos], inc[NumLfos], cycle[NumLfos];
+        alignas (32) float s[NumLfos], c[NumLfos], rotCos[NumLfos], rotSin[NumLfos];
+        alignas (32) float from[NumLfos], to[NumLfos];
+        alignas (32) juce::uint32 rng[NumLfos];
+
+        for (int lane = 0; lane < NumLfos; ++lane)
+        {
+            start[lane] = (float) phase[lane];
+            inc[lane] = (float) increment[lane];
+            cycle[lane] = 0.0f;
+            rotCos[lane] = rotationCos[lane];
+            rotSin[lane] = rotationSin[lane];
+            from[lane] = randomFrom[lane];
+            to[lane] = randomTo[lane];
+            rng[lane] = randomState[lane];
+
+            // Re-seed the rotation from the phase: no drift carried across chunks
+            const double angle = juce::MathConstants<double>::twoPi * phase[lane];
+            s[lane] = (float) std::sin (angle);
+            c[lane] = (float) std::cos (angle);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* out = dest + (size_t) i * NumLfos;
+            const float fi = (float) i;
+
+            for (int lane = 0; lane < NumLfos; ++lane)
+            {
+                // Phase from the chunk start rather than accumulated, so the wrap isn't part
+                // of a chain from one sample to the next. Truncations and 0/1 blends instead
+                // of compares and branches: the lane loop vectorises without fast-math.
+                const float t = start[lane] + fi * inc[lane];
+                const float whole = (float) (int) t;
+                const float ph = t - whole;
+                const float wrapped = whole - cycle[lane]; // 1 on the first sample of a cycle
+                cycle[lane] = whole;
+
+                // xorshift32 steps every sample; its value is latched as the new random
+                // target when a cycle starts
+                juce::uint32 x = rng[lane];
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                rng[lane] = x;
+
+                const float drawn = (float) (juce::int32) x * (1.0f / 2147483648.0f);
+                from[lane] += wrapped * (to[lane] - from[lane]);
+                to[lane]   += wrapped * (drawn - to[lane]);
+
+                // Triangle a quarter cycle ahead so it starts at 0 rising, like the sine
+                float q = ph + 0.25f;
+                q -= (float) (int) q;
+                const float triangle = 1.0f - 4.0f * std::abs (q - 0.5f);
+                const float saw = 2.0f * ph - 1.0f;
+                const float smooth = ph * ph * (3.0f - 2.0f * ph); // smoothstep glide
+                const float random = from[lane] + (to[lane] - from[lane]) * smooth;
+
+                out[lane] = weightSine[lane] * s[lane]
+                          + weightTriangle[lane] * triangle
+                          + weightSaw[lane] * saw
+                          + weightRandom[lane] * random
+                          + weightHold[lane] * to[lane];
+
+                // Rotate (sin, cos) by the increment
+                const float nextS = s[lane] * rotCos[lane] + c[lane] * rotSin[lane];
+                const float nextC = c[lane] * rotCos[lane] - s[lane] * rotSin[lane];
+                s[lane] = nextS;
+                c[lane] = nextC;
+            }
+        }
+
+        for (int lane = 0; lane < NumLfos; ++lane)
+        {
+            const double next = phase[lane] + increment[lane] * (double) numSamples;
+            phase[lane] = next - std::floor (next);
+            randomFrom[lane] = from[lane];
+            randomTo[lane] = to[lane];
+            randomState[lane] = rng[lane];
+        }
+    }
+
+    void setIncrement (int lane, double cyclesPerSample) noexcept
+    {
+        // Below 0.5 cycles/sample: an LFO never gets near Nyquist, and the random shapes
+        // assume at most one new cycle per sample
+        const double inc = juce::jlimit (0.0, 0.5, cyclesPerSample);
+        increment[lane] = inc;
+        rotationCos[lane] = (float) std::cos (juce::MathConstants<double>::twoPi * inc);
+        rotationSin[lane] = (float) std::sin (juce::MathConstants<double>::twoPi * inc);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LfoBank)
+};
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "MeterValues.h"
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define METER_KERNEL_SSE 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #include <arm_neon.h>
+ #define METER_KERNEL_NEON 1
+#endif
+
+//==============================================================================
+// Block statistics for the meters: sum of squares, min and max (and from them RMS and
+// absolute peak) of every channel, in one pass over the samples.
+//
+// - SIMD: numLanes samples at a time go into numLanes independent accumulators (four
+//   registers of 4 floats: SSE2 on Intel, NEON on ARM, plain floats elsewhere) instead
+//   of the one long dependency chain of `sum += (double) s * s`. Compilers don't
+//   reliably vectorise the min/max of a plain loop, hence the small Float4 wrapper.
+// - Accuracy: the lanes add squares in float over one chunk (chunkSize samples, so
+//   chunkSize / numLanes terms per lane), then the chunk's lanes are added pairwise and
+//   carried in double. Rounding can't grow with the block size, and the result agrees
+//   with the scalar double reference (analyseReference) to float precision.
+// - Results go into arrays the caller owns (ChannelStats[], MeterValues): nothing is
+//   allocated, so it is safe on the audio thread.
+//
+// Usage (audio thread):
+//   MeterKernel::computeRms (*buffer, start, n, instantRms); // MeterValues<>, one per channel
+namespace MeterKernel
+{
+    //==============================================================================
+    // 4 floats in one register, with just what the meters need (also used by TruePeakMeter)
+    struct Float4
+    {
+       #if METER_KERNEL_SSE
+        __m128 v;
+
+        static Float4 load (const float* p) noexcept                    { return { _mm_loadu_ps (p) }; }
+        static Float4 fill (float x) noexcept                           { return { _mm_set1_ps (x) }; }
+        void store (float* p) const noexcept                            { _mm_storeu_ps (p, v); }
+
+        friend Float4 operator+ (Float4 a, Float4 b) noexcept           { return { _mm_add_ps (a.v, b.v) }; }
+        friend Float4 operator* (Float4 a, Float4 b) noexcept           { return { _mm_mul_ps (a.v, b.v) }; }
+        static Float4 min (Float4 a, Float4 b) noexcept                 { return { _mm_min_ps (a.v, b.v) }; }
+        static Float4 max (Float4 a, Float4 b) noexcept                 { return { _mm_max_ps (a.v, b.v) }; }
+        static Float4 abs (Float4 a) noexcept                           { return { _mm_andnot_ps (_mm_set1_ps (-0.0f), a.v) }; }
+       #elif METER_KERNEL_NEON
+        float32x4_t v;
+
+        static Float4 load (const float* p) noexcept                    { return { vld1q_f32 (p) }; }
+        static Float4 fill (float x) noexcept                           { return { vdupq_n_f32 (x) }; }
+        void store (float* p) const noexcept                            { vst1q_f32 (p, v); }
+
+        friend Float4 operator+ (Float4 a, Float4 b) noexcept           { return { vaddq_f32 (a.v, b.v) }; }
+        friend Float4 operator* (Float4 a, Float4 b) noexcept           { return { vmulq_f32 (a.v, b.v) }; }
+        static Float4 min (Float4 a, Float4 b) noexcept                 { return { vminq_f32 (a.v, b.v) }; }
+        static Float4 max (Float4 a, Float4 b) noexcept                 { return { vmaxq_f32 (a.v, b.v) }; }
+        static Float4 abs (Float4 a) noexcept                           { return { vabsq_f32 (a.v) }; }
+       #else
+        float v[4];
+
+        static Float4 load (const float* p) noexcept                    { return { { p[0], p[1], p[2], p[3] } }; }
+        static Float4 fill (float x) noexcept                           { return { { x, x, x, x } }; }
+        void store (float* p) const noexcept                            { std::copy (v, v + 4, p); }
+
+        template <typename Op>
+        static Float4 apply (Float4 a, Float4 b, Op op) noexcept        { return { { op (a.v[0], b.v[0]), op (a.v[1], b.v[1]), op (a.v[2], b.v[2]), op (a.v[3], b.v[3]) } }; }
+
+        friend Float4 operator+ (Float4 a, Float4 b) noexcept           { return apply (a, b, [] (float x, float y) { return x + y; }); }
+        friend Float4 operator* (Float4 a, Float4 b) noexcept           { return apply (a, b, [] (float x, float y) { return x * y; }); }
+        static Float4 min (Float4 a, Float4 b) noexcept                 { return apply (a, b, [] (float x, float y) { return juce::jmin (x, y); }); }
+        static Float4 max (Float4 a, Float4 b) noexcept                 { return apply (a, b, [] (float x, float y) { return juce::jmax (x, y); }); }
+        static Float4 abs (Float4 a) noexcept                           { return apply (a, a, [] (float x, float) { return std::abs (x); }); }
+       #endif
+    };
+
+    // One register's worth of lanes: sum of squares over the current chunk, min and max
+    struct Lanes
+    {
+        Float4 squares, lo, hi;
+
+        explicit Lanes (float first) noexcept
+            : squares (Float4::fill (0.0f)), lo (Float4::fill (first)), hi (Float4::fill (first)) {}
+
+        void add (Float4 s) noexcept
+        {
+            squares = squares + s * s;
+            lo = Float4::min (lo, s);
+            hi = Float4::max (hi, s);
+        }
+    };
+
+    constexpr int numLanes = 16;    // four Lanes, unrolled by hand so they stay in registers
+    constexpr int chunkSize = 256;
+
+    struct ChannelStats
+    {
+        double sumOfSquares = 0.0;
+        float min = 0.0f;
+        float max = 0.0f;
+
+        float getPeak() const noexcept                  { return juce::jmax (max, -min); }
+
+        float getRms (int numSamples) const noexcept
+        {
+            return numSamples > 0 ? std::sqrt ((float) (sumOfSquares / (double) numSamples)) : 0.0f;
+        }
+    };
+
+    //==============================================================================
+    // One channel: numSamples samples from data
+    inline ChannelStats analyseChannel (const float* data, int numSamples) noexcept
+    {
+        ChannelStats stats;
+
+        if (numSamples <= 0)
+            return stats;
+
+        Lanes a (data[0]), b (data[0]), c (data[0]), d (data[0]);
+        float tailLo = data[0], tailHi = data[0];
+        float lanes[4];
+
+        for (int chunkStart = 0; chunkStart < numSamples; chunkStart += chunkSize)
+        {
+            const float* x = data + chunkStart;
+            const int n = juce::jmin (chunkSize, numSamples - chunkStart);
+            const int numWhole = n - n % numLanes;
+
+            a.squares = b.squares = c.squares = d.squares = Float4::fill (0.0f);
+
+            for (int i = 0; i < numWhole; i += numLanes)
+            {
+                a.add (Float4::load (x + i));
+                b.add (Float4::load (x + i + 4));
+                c.add (Float4::load (x + i + 8));
+                d.add (Float4::load (x + i + 12));
+            }
+
+            // pairwise: registers, then the 4 lanes, then into the double total
+            ((a.squares + b.squares) + (c.squares + d.squares)).store (lanes);
+            float chunkSum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+            for (int i = numWhole; i < n; ++i)
+            {
+                const float s = x[i];
+                chunkSum += s * s;
+                tailLo = juce::jmin (tailLo, s);
+                tailHi = juce::jmax (tailHi, s);
+            }
+
+            stats.sumOfSquares += (double) chunkSum;
+        }
+
+        Float4::min (Float4::min (a.lo, b.lo), Float4::min (c.lo, d.lo)).store (lanes);
+        stats.min = juce::jmin (tailLo, juce::jmin (lanes[0], lanes[1], lanes[2], lanes[3]));
+
+        Float4::max (Float4::max (a.hi, b.hi), Float4::max (c.hi, d.hi)).store (lanes);
+        stats.max = juce::jmax (tailHi, juce::jmax (lanes[0], lanes[1], lanes[2], lanes[3]));
+
+        return stats;
+    }
+
+    // Every channel of buffer in [startSample, startSample + numSamples): results[ch] for
+    // the first maxResults channels. Returns the number of channels written.
+    inline int analyse (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                        ChannelStats* results, int maxResults) noexcept
+    {
+        const int numChannels = juce::jmin (buffer.getNumChannels(), maxResults);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            results[ch] = analyseChannel (buffer.getReadPointer (ch, startSample), numSamples);
+
+        return numChannels;
+    }
+
+    // RMS of every channel (up to MaxChannels) into rms, sized to the buffer's channels
+    template <int MaxChannels>
+    inline void computeRms (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                            MeterValues<MaxChannels>& rms) noexcept
+    {
+        rms.reset (buffer.getNumChannels());
+
+        for (int ch = 0; ch < rms.size(); ++ch)
+            rms.set (ch, analyseChannel (buffer.getReadPointer (ch, startSample), numSamples).getRms (numSamples));
+    }
+
+    //==============================================================================
+    // The scalar loop the meters used to run, in double: reference for the benchmark
+    inline ChannelStats analyseReference (const float* data, int numSamples) noexcept
+    {
+        ChannelStats stats;
+
+        if (numSamples <= 0)
+            return stats;
+
+        stats.min = stats.max = data[0];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float s = data[i];
+            stats.sumOfSquares += (double) s * (double) s;
+            stats.min = juce::jmin (stats.min, s);
+            stats.max = juce::jmax (stats.max, s);
+        }
+
+        return stats;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "MeterKernel.h"
+
+//==============================================================================
+// ns per block of the meters' old scalar loop (MeterKernel::analyseReference) and of
+// MeterKernel::analyseChannel, stereo, block sizes 32 .. 4096, plus the largest relative
+// difference between the two RMS, peak and min/max results on noise, a quiet signal and
+// a loud DC offset. Part of the Benchmarks console app; logAll() returns false if the
+// kernel disagrees with the reference.
+namespace MeterKernelBenchmark
+{
+    struct Figures { double referenceNs, kernelNs, maxRmsError; bool extremesMatch; };
+
+    inline Figures measure (int blockSize, int numChannels = 2, int totalSamples = 1 << 22)
+    {
+        const int numBlocks = juce::jmax (1, totalSamples / blockSize);
+
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+        juce::Random rng (2024);
+
+        Figures figures { 0.0, 0.0, 0.0, true };
+
+        // 0: full-scale noise, 1: noise at -80 dB, 2: 0.9 DC plus a little noise
+        for (int signal = 0; signal < 3; ++signal)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const float noise = rng.nextFloat() * 2.0f - 1.0f;
+                    buffer.setSample (ch, i, signal == 0 ? noise : signal == 1 ? 1.0e-4f * noise : 0.9f + 1.0e-3f * noise);
+                }
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto ref = MeterKernel::analyseReference (buffer.getReadPointer (ch), blockSize);
+                const auto got = MeterKernel::analyseChannel (buffer.getReadPointer (ch), blockSize);
+
+                const auto refRms = (double) ref.getRms (blockSize);
+                const auto error = std::abs ((double) got.getRms (blockSize) - refRms) / juce::jmax (refRms, 1.0e-30);
+                figures.maxRmsError = juce::jmax (figures.maxRmsError, error);
+                figures.extremesMatch = figures.extremesMatch && got.min == ref.min && got.max == ref.max
+                                                              && got.getPeak() == ref.getPeak();
+            }
+        }
+
+        MeterKernel::ChannelStats stats[8];
+        float sink = 0.0f;
+
+        auto timeIt = [&] (auto&& analyse)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    stats[ch] = analyse (buffer.getReadPointer (ch), blockSize);
+
+                sink += stats[0].getRms (blockSize);
+            }
+
+            const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+            return seconds * 1.0e9 / (double) numBlocks;
+        };
+
+        figures.referenceNs = timeIt ([] (const float* data, int n) { return MeterKernel::analyseReference (data, n); });
+        figures.kernelNs    = timeIt ([] (const float* data, int n) { return MeterKernel::analyseChannel (data, n); });
+
+        volatile float keepAlive = sink; // stops the loops being optimised away
+        juce::ignoreUnused (keepAlive);
+
+        return figures;
+    }
+
+    inline bool logAll()
+    {
+        bool passed = true;
+
+        for (int blockSize = 32; blockSize <= 4096; blockSize *= 2)
+        {
+            const auto f = measure (blockSize);
+
+            juce::String line;
+            line << "Meter kernel stereo @ " << blockSize << " samples - scalar double: " << f.referenceNs
+                 << " ns/block, kernel: " << f.kernelNs << " ns/block ("
+                 << (f.kernelNs > 0.0 ? f.referenceNs / f.kernelNs : 0.0) << "x), max RMS error "
+                 << f.maxRmsError << (f.extremesMatch ? "" : "  PEAK/MIN/MAX MISMATCH");
+            juce::Logger::writeToLog (line);
+
+            passed = passed && f.maxRmsError < 1.0e-5 && f.extremesMatch;
+        }
+
+        return passed;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Per-channel meter readings (RMS, peak, band levels, ...) with a fixed capacity.
+//
+// The audio thread owns one, updates it every block and publishes a copy through a
+// RealtimeParams<MeterValues<>> (audio thread = writer, UI = reader). Publishing is a
+// ~260 byte copy plus one atomic exchange, so the audio thread never waits for the UI.
+// Reading never allocates, and the UI always gets every channel from the same block.
+// It reads like the juce::Array<float> it replaces: size(), set(), operator[] (0 past
+// the channels in use) and range-for over the channels in use.
+//
+// Usage:
+//   audio thread:  levels.set (ch, rms); ... published.write (levels);
+//   UI thread:     const auto latest = published.read();
+template <int MaxChannels = 64>
+struct MeterValues
+{
+    static constexpr int maxChannels = MaxChannels;
+
+    int numChannels = 0;
+    float values[MaxChannels] {};
+
+    // Channels in use (clamped to maxChannels), all back to 0
+    void reset (int newNumChannels) noexcept
+    {
+        numChannels = juce::jlimit (0, MaxChannels, newNumChannels);
+        std::fill (std::begin (values), std::end (values), 0.0f);
+    }
+
+    void set (int channel, float value) noexcept
+    {
+        if (juce::isPositiveAndBelow (channel, numChannels))
+            values[channel] = value;
+    }
+
+    float operator[] (int channel) const noexcept
+    {
+        return juce::isPositiveAndBelow (channel, numChannels) ? values[channel] : 0.0f;
+    }
+
+    int  size() const noexcept              { return numChannels; }
+    bool isEmpty() const noexcept           { return numChannels == 0; }
+
+    const float* begin() const noexcept     { return values; }
+    const float* end() const noexcept       { return values + numChannels; }
+};
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayLine.h"
+#include "RealtimeParams.h"
+
+//==============================================================================
+// Bank of NumStrings Karplus-Strong plucked strings (Karplus & Strong; Jaffe & Smith,
+// "Extensions of the Karplus-Strong Plucked-String Algorithm").
+//
+// Each string is a delay loop tuned to the note's period:
+//   integer delay (the DelayLine read) + two-point average (loss filter, half a sample)
+//   + first-order allpass (the fractional rest, 0.1 .. 1.1 samples)
+// A note-on plays a one-period burst of filtered noise into the loop (velocity sets
+// level and brightness); the loop gain sets the decay time, and a note-off drops it so
+// the string is damped like a lifted finger.
+//
+// All strings live in one DelayLine with one lane per string (like FdnReverb), so the
+// per-sample work - loss filter, allpass, noise burst, write - is one branch-free loop
+// over NumStrings lanes the compiler vectorises. Every string runs every sample: the
+// cost is fixed, 64 strings ringing at once cost the same as one.
+//
+// Notes are played with noteOn()/noteOff() or renderNextBlock() from a MidiBuffer (split
+// at the events, so they're sample accurate). Parameters come in through RealtimeParams.
+template <int NumStrings = 64>
+class PluckedStrings
+{
+public:
+    static_assert (NumStrings % 8 == 0, "PluckedStrings processes strings in groups of 8");
+
+    struct Parameters
+    {
+        float decaySeconds = 4.0f;      // ring time (to -60 dB) of a held note at 220 Hz
+        float releaseSeconds = 0.2f;    // after note-off
+        float brightness = 0.7f;        // 0 .. 1, colour of the pluck
+    };
+
+    PluckedStrings() = default;
+
+    //==============================================================================
+    // message thread (audio stopped): allocates the loops for notes down to lowestHz
+    void prepare (double sampleRate, float lowestHz = 27.5f)
+    {
+        currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+
+        const int maxPeriod = (int) std::ceil (currentSampleRate / (double) juce::jmax (10.0f, lowestHz)) + 2;
+        line.prepare (maxPeriod, NumStrings);
+
+        reset();
+    }
+
+    void release()
+    {
+        line.release();
+    }
+
+    void reset() noexcept
+    {
+        line.reset();
+
+        for (int s = 0; s < NumStrings; ++s)
+        {
+            noteOfString[s] = -1;
+            released[s] = false;
+            age[s] = 0;
+            releaseCountdown[s] = 0;
+
+            delayOf[s] = line.getMaximumDelayInSamples();
+            loopGain[s] = 0.0f;
+            allpassCoeff[s] = 0.0f;
+            lossPrev[s] = allpassX[s] = allpassY[s] = 0.0f;
+            burstLeft[s] = 0;
+            burstLevel[s] = 0.0f;
+            burstCoeff[s] = 1.0f;
+            burstState[s] = 0.0f;
+            noiseState[s] = 0x2545f491u * (juce::uint32) (s + 1);
+        }
+    }
+
+    // message thread (a single writer)
+    void setParameters (const Parameters& newParams) noexcept
+    {
+        auto p = newParams;
+        p.decaySeconds = juce::jlimit (0.1f, 30.0f, p.decaySeconds);
+        p.releaseSeconds = juce::jlimit (0.01f, 5.0f, p.releaseSeconds);
+        p.brightness = juce::jlimit (0.0f, 1.0f, p.brightness);
+        params.write (p);
+    }
+
+    const Parameters& getParameters() const noexcept    { return params.getLastWritten(); }
+
+    //==============================================================================
+    // audio thread
+
+    void noteOn (int midiNote, float velocity) noexcept
+    {
+        if (! line.isPrepared())
+            return;
+
+        const auto& p = params.read();
+        const int s = findString (midiNote);
+
+        const double hz = 440.0 * std::pow (2.0, (midiNote - 69) / 12.0);
+        const double period = juce::jlimit (2.0, (double) line.getMaximumDelayInSamples(), currentSampleRate / hz);
+
+        // period = integer delay + 0.5 (loss filter) + allpass delay in [0.1, 1.1)
+        const int integerDelay = juce::jmax (1, (int) std::floor (period - 0.6));
+        const double fraction = period - 0.5 - integerDelay;
+
+        noteOfString[s] = midiNote;
+        released[s] = false;
+        age[s] = ++ageCounter;
+
+        delayOf[s] = integerDelay;
+        allpassCoeff[s] = (float) ((1.0 - fraction) / (1.0 + fraction));
+        loopGain[s] = gainForDecay (period, decayForNote (p.decaySeconds, hz));
+
+        // one period of noise, lowpassed more for soft notes and a dark setting
+        const float v = juce::jlimit (0.0f, 1.0f, velocity);
+        burstLeft[s] = juce::jmax (1, (int) period);
+        burstLevel[s] = 0.5f * v;
+        burstCoeff[s] = juce::jlimit (0.05f, 1.0f, 0.15f + 0.85f * p.brightness * (0.4f + 0.6f * v));
+    }
+
+    void noteOff (int midiNote) noexcept
+    {
+        const auto& p = params.read();
+
+        for (int s = 0; s < NumStrings; ++s)
+        {
+            if (noteOfString[s] == midiNote && ! released[s])
+            {
+                released[s] = true;
+                const double period = (double) delayOf[s] + 1.0;
+                loopGain[s] = gainForDecay (period, p.releaseSeconds);
+                releaseCountdown[s] = (int) (p.releaseSeconds * currentSampleRate);
+            }
+        }
+    }
+
+    void allNotesOff() noexcept
+    {
+        for (int s = 0; s < NumStrings; ++s)
+            if (noteOfString[s] >= 0)
+                noteOff (noteOfString[s]);
+    }
+
+    // Plays the notes in `midi` (sample positions from startSample) into output[0 .. numSamples)
+    void renderNextBlock (float* output, const juce::MidiBuffer& midi, int startSample, int numSamples) noexcept
+    {
+        int done = 0;
+
+        for (const auto metadata : midi)
+        {
+            const int pos = juce::jlimit (0, numSamples, metadata.samplePosition - startSample);
+
+            if (pos > done)
+            {
+                process (output + done, pos - done);
+                done = pos;
+            }
+
+            const auto message = metadata.getMessage();
+
+            if (message.isNoteOn())
+                noteOn (message.getNoteNumber(), message.getFloatVelocity());
+            else if (message.isNoteOff())
+                noteOff (message.getNoteNumber());
+            else if (message.isAllNotesOff() || message.isAllSoundOff())
+                allNotesOff();
+        }
+
+        if (numSamples > done)
+            process (output + done, numSamples - done);
+    }
+
+    // Writes the summed strings to output (mono)
+    void process (float* output, int numSamples) noexcept
+    {
+        if (! line.isPrepared())
+        {
+            juce::FloatVectorOperations::clear (output, numSamples);
+            return;
+        }
+
+        juce::ScopedNoDenormals noDenormals; // decaying loops would otherwise end up denormal
+
+        alignas (32) float delayed[NumStrings];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            line.readLanes (delayOf, delayed);
+            float* frame = line.getWriteFrame();
+
+            for (int s = 0; s < NumStrings; ++s)
+            {
+                // Loss filter: two-point average and the decay gain
+                const float x = delayed[s];
+                const float lowpassed = loopGain[s] * 0.5f * (x + lossPrev[s]);
+                lossPrev[s] = x;
+
+                // Allpass for the fractional part of the period
+                const float y = allpassCoeff[s] * (lowpassed - allpassY[s]) + allpassX[s];
+                allpassX[s] = lowpassed;
+                allpassY[s] = y;
+
+                // Pluck: lowpassed noise while the burst lasts (xorshift32)
+                juce::uint32 n = noiseState[s];
+                n ^= n << 13;
+                n ^= n >> 17;
+                n ^= n << 5;
+                noiseState[s] = n;
+
+                const float noise = (float) (juce::int32) n * (1.0f / 2147483648.0f);
+                burstState[s] += burstCoeff[s] * (noise - burstState[s]);
+
+                const int burstOn = burstLeft[s] > 0 ? 1 : 0;
+                burstLeft[s] -= burstOn;
+
+                frame[s] = y + (float) burstOn * burstLevel[s] * burstState[s];
+            }
+
+            // Sum in 8 running partial sums, so the adds vectorise without reordering
+            alignas (32) float partial[8] = {};
+            for (int s = 0; s < NumStrings; s += 8)
+                for (int k = 0; k < 8; ++k)
+                    partial[k] += frame[s + k];
+
+            output[i] = ((partial[0] + partial[1]) + (partial[2] + partial[3]))
+                      + ((partial[4] + partial[5]) + (partial[6] + partial[7]));
+
+            line.advance();
+        }
+
+        // Released strings are free again once their release time has passed
+        for (int s = 0; s < NumStrings; ++s)
+        {
+            if (released[s] && noteOfString[s] >= 0)
+            {
+                releaseCountdown[s] -= numSamples;
+                if (releaseCountdown[s] <= 0)
+                    noteOfString[s] = -1;
+            }
+        }
+    }
+
+private:
+    DelayLine<float, DelayLineInterpolation::None> line; // lane = string
+
+    // Per-string loop state (one lane each)
+    alignas (32) int delayOf[NumStrings] {};
+    alignas (32) float loopGain[NumStrings] {};
+    alignas (32) float allpassCoeff[NumStrings] {};
+    alignas (32) float lossPrev[NumStrings] {};
+    alignas (32) float allpassX[NumStrings] {};
+    alignas (32) float allpassY[NumStrings] {};
+    alignas (32) int burstLeft[NumStrings] {};
+    alignas (32) float burstLevel[NumStrings] {};
+    alignas (32) float burstCoeff[NumStrings] {};
+    alignas (32) float burstState[NumStrings] {};
+    alignas (32) juce::uint32 noiseState[NumStrings] {};
+
+    // Voice allocation
+    int noteOfString[NumStrings] {};        // -1 = free
+    bool released[NumStrings] {};
+    juce::uint32 age[NumStrings] {};
+    int releaseCountdown[NumStrings] {};
+    juce::uint32 ageCounter = 0;
+
+    double currentSampleRate = 44100.0;
+    RealtimeParams<Parameters> params;
+
+    // Same note again: reuse its string. Otherwise a free string, else the oldest released
+    // one, else the oldest.
+    int findString (int midiNote) const noexcept
+    {
+        int best = -1;
+        int bestRank = -1;
+        juce::uint32 bestAge = 0;
+
+        for (int s = 0; s < NumStrings; ++s)
+        {
+            const int rank = noteOfString[s] == midiNote ? 3 : noteOfString[s] < 0 ? 2 : released[s] ? 1 : 0;
+
+            if (rank > bestRank || (rank == bestRank && age[s] < bestAge))
+            {
+                best = s;
+                bestRank = rank;
+                bestAge = age[s];
+            }
+        }
+
+        return best;
+    }
+
+    // Low notes ring longer than high ones (as on a real instrument)
+    static double decayForNote (float decaySeconds, double hz) noexcept
+    {
+        return (double) decaySeconds * juce::jlimit (0.25, 4.0, std::sqrt (220.0 / hz));
+    }
+
+    // Loop gain that loses 60 dB in `seconds` for a loop of `period` samples
+    float gainForDecay (double period, double seconds) const noexcept
+    {
+        return (float) std::pow (0.001, period / (currentSampleRate * seconds));
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluckedStrings)
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Hands a block of parameters from the message thread to the audio thread without
+// locks and without tearing (the reader never sees half of an update).
+//
+// Triple buffer: the writer fills its own slot and swaps it with the shared "middle"
+// slot; the reader swaps the middle slot with its own only when something new was
+// published. Each side only ever touches its own slot, so the swap is one atomic
+// exchange and neither side waits for the other. Older updates the reader never
+// picked up are simply overwritten: only the latest snapshot matters.
+//
+// One writer thread and one reader thread. T must be trivially copyable (a plain
+// struct of numbers/enums). It works the other way round too: meters publish their
+// readings from the audio thread to the UI with it (see MeterValues.h).
+//
+// Usage:
+//   message thread:  params.update ([&] (Params& p) { p.feedback = v; });
+//   audio thread:    const auto& p = params.read(); // once per block, then smooth per sample
+template <typename T>
+class RealtimeParams
+{
+public:
+    static_assert (std::is_trivially_copyable<T>::value, "RealtimeParams needs a trivially copyable type");
+
+    explicit RealtimeParams (const T& initialValue = T {})
+        : lastWritten (initialValue)
+    {
+        for (auto& slot : slots)
+            slot = initialValue;
+    }
+
+    //==============================================================================
+    // Writer side
+
+    void write (const T& newValue) noexcept
+    {
+        lastWritten = newValue;
+        slots[backIndex] = newValue;
+        backIndex = middle.exchange (backIndex | newDataFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Changes some fields of the last written value and publishes the result
+    template <typename Function>
+    void update (Function&& changeValue) noexcept
+    {
+        T newValue = lastWritten;
+        changeValue (newValue);
+        write (newValue);
+    }
+
+    // Last value passed to write(), for the writer's own use (e.g. initial control values)
+    const T& getLastWritten() const noexcept        { return lastWritten; }
+
+    //==============================================================================
+    // Reader side: latest published value. The reference stays valid until the next read().
+    const T& read() noexcept
+    {
+        if ((middle.load (std::memory_order_relaxed) & newDataFlag) != 0)
+            frontIndex = middle.exchange (frontIndex, std::memory_order_acq_rel) & indexMask;
+
+        return slots[frontIndex];
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newDataFlag = 4;
+
+    T slots[3];
+    std::atomic<int> middle { 1 };  // slot index, plus newDataFlag when unread
+    int backIndex = 0;              // writer only
+    int frontIndex = 2;             // reader only
+
+    T lastWritten;                  // writer only
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeParams)
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "MeterKernel.h"
+
+//==============================================================================
+// True-peak meter after ITU-R BS.1770-4, Annex 2: every channel is upsampled 4x with
+// the 48-tap polyphase FIR of the recommendation and the peak is taken on the
+// upsampled signal, so inter-sample overs that a sample peak misses (a full-scale sine
+// sampled off its crest, a clipped master after the DAC) are caught. Read in dBTP.
+//
+// - The four phases run side by side: each input sample is multiplied into one
+//   Float4 per tap (12 of them, [tap][phase]) and accumulated, so one register yields
+//   the 4 upsampled outputs of that sample. Channels run one after the other over the
+//   same coefficient registers; about 12 vector multiply-adds per sample and channel,
+//   cheap enough for every channel of every meter.
+// - No allocation: the last 11 samples of each channel are kept between blocks and the
+//   block is filtered in chunks through a fixed buffer on the stack.
+// - Peak hold per channel: the highest true peak is held for the hold time, then drops
+//   to the current block's. A hold time of 0 holds until resetHold().
+// - Floating point all the way, so the 12.04 dB input attenuation the recommendation
+//   suggests for fixed-point implementations isn't needed.
+//
+// Usage (audio thread):
+//   truePeak.prepare (sampleRate, numChannels);                 // prepareToPlay
+//   truePeak.process (*buffer, start, n);                       // every block
+//   published.write (truePeak.getHeldPeaks());                  // linear, toDecibels() for dBTP
+template <int MaxChannels = 64>
+class TruePeakMeter
+{
+public:
+    static constexpr int numPhases = 4;
+    static constexpr int numTaps = 12;     // per phase
+
+    TruePeakMeter()
+    {
+        // BS.1770-4 Annex 2, phase by phase
+        static const float coefficients[numPhases][numTaps] =
+        {
+            {  0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f, -0.0594482421875f,  0.1373291015625f,
+               0.9721679687500f, -0.1022949218750f,  0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f },
+            { -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f, -0.1665039062500f,  0.4650878906250f,
+               0.7797851562500f, -0.2003173828125f,  0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f },
+            { -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f, -0.2003173828125f,  0.7797851562500f,
+               0.4650878906250f, -0.1665039062500f,  0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f },
+            { -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f, -0.1022949218750f,  0.9721679687500f,
+               0.1373291015625f, -0.0594482421875f,  0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f }
+        };
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            float phases[numPhases];
+
+            for (int phase = 0; phase < numPhases; ++phase)
+                phases[phase] = coefficients[phase][tap];
+
+            taps[tap] = MeterKernel::Float4::load (phases);
+        }
+
+        prepare (44100.0, 0);
+    }
+
+    //==============================================================================
+    void prepare (double sampleRate, int numChannels) noexcept
+    {
+        currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+        blockPeaks.reset (numChannels);
+        setHoldTime (holdSeconds);
+        reset();
+    }
+
+    // Clears the filter history and the held peaks
+    void reset() noexcept
+    {
+        for (auto& channel : history)
+            std::fill (std::begin (channel), std::end (channel), 0.0f);
+
+        blockPeaks.reset (blockPeaks.size());
+        resetHold();
+    }
+
+    void resetHold() noexcept
+    {
+        heldPeaks.reset (blockPeaks.size());
+        std::fill (std::begin (holdSamplesLeft), std::end (holdSamplesLeft), 0);
+    }
+
+    // How long a peak stays on the display; 0 holds it until resetHold()
+    void setHoldTime (double seconds) noexcept
+    {
+        holdSeconds = juce::jmax (0.0, seconds);
+        holdSamples = (juce::int64) (holdSeconds * currentSampleRate);
+    }
+
+    //==============================================================================
+    // True peak of every channel in [startSample, startSample + numSamples) (channels
+    // past the ones prepared are ignored), and the held peaks updated with it
+    void process (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        const int numChannels = juce::jmin (buffer.getNumChannels(), blockPeaks.size());
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float peak = processChannel (buffer.getReadPointer (ch, startSample), numSamples, history[ch]);
+            blockPeaks.set (ch, peak);
+
+            if (peak >= heldPeaks[ch])
+            {
+                heldPeaks.set (ch, peak);
+                holdSamplesLeft[ch] = holdSamples;
+            }
+            else if (holdSamples > 0 && (holdSamplesLeft[ch] -= numSamples) <= 0)
+            {
+                heldPeaks.set (ch, peak);
+                holdSamplesLeft[ch] = holdSamples;
+            }
+        }
+    }
+
+    // Linear: 1 = 0 dBTP
+    const MeterValues<MaxChannels>& getBlockPeaks() const noexcept     { return blockPeaks; }
+    const MeterValues<MaxChannels>& getHeldPeaks() const noexcept      { return heldPeaks; }
+
+    static float toDecibels (float truePeak) noexcept                  { return juce::Decibels::gainToDecibels (truePeak, -100.0f); }
+
+private:
+    static constexpr int historySize = numTaps - 1;
+    static constexpr int chunkSize = 256;
+
+    MeterKernel::Float4 taps[numTaps];
+    float history[MaxChannels][historySize] {};   // last input samples of each channel, oldest first
+
+    MeterValues<MaxChannels> blockPeaks, heldPeaks;
+    juce::int64 holdSamplesLeft[MaxChannels] {};
+    juce::int64 holdSamples = 0;
+    double holdSeconds = 2.0;
+    double currentSampleRate = 44100.0;
+
+    float processChannel (const float* input, int numSamples, float (&last)[historySize]) const noexcept
+    {
+        using Float4 = MeterKernel::Float4;
+
+        float work[historySize + chunkSize];
+        std::copy (std::begin (last), std::end (last), work);
+
+        auto peak = Float4::fill (0.0f);
+
+        for (int chunkStart = 0; chunkStart < numSamples; chunkStart += chunkSize)
+        {
+            const int n = juce::jmin (chunkSize, numSamples - chunkStart);
+            std::copy (input + chunkStart, input + chunkStart + n, work + historySize);
+
+            for (int i = 0; i < n; ++i)
+            {
+                const float* x = work + historySize + i;    // x[-k] = input k samples ago
+                auto y = taps[0] * Float4::fill (x[0]);
+
+                for (int tap = 1; tap < numTaps; ++tap)
+                    y = y + taps[tap] * Float4::fill (x[-tap]);
+
+                peak = Float4::max (peak, Float4::abs (y));
+            }
+
+            // the last samples of this chunk are the history of the next one
+            std::copy (work + n, work + n + historySize, work);
+        }
+
+        std::copy (work, work + historySize, last);
+
+        float phases[numPhases];
+        peak.store (phases);
+        return juce::jmax (phases[0], phases[1], phases[2], phases[3]);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TruePeakMeter)
+};